@@ -1,46 +1,64 @@
 #include "DonneesGTFS.h"
-#include <fstream>
+#include "lecteurCSV.h"
+#include "instantaneArrets.h"
+#include <thread>
+#include <exception>
 
 using namespace std;
 
+namespace
+{
+    //! \brief arrêt retenu par un fil d'exécution, en attendant d'être ajouté à son voyage et à sa station
+    struct ArretLu
+    {
+        Voyage *voyage;
+        Arret::Ptr arret;
+    };
+
+    const size_t tailleMinMorceau = 1 << 20; /*!< en octets; en deçà, un seul fil lit le fichier */
+
+    //! \brief vérifie qu'une ligne du fichier contient au moins p_nbChamps champs
+    //! \throws logic_error sinon
+    void verifierNbChamps(const LecteurCSV &p_lecteur, const vector<string_view> &p_champs, size_t p_nbChamps)
+    {
+        if (p_champs.size() < p_nbChamps)
+            throw logic_error("ligne " + to_string(p_lecteur.getNumeroLigne()) + ": " + to_string(p_nbChamps) +
+                              " champs attendus, " + to_string(p_champs.size()) + " trouvés");
+    }
 
+    //! \brief retire de p_conteneur (voyages ou stations) les éléments sans arrêt
+    template<typename Conteneur>
+    void retirerSansArrets(Conteneur &p_conteneur)
+    {
+        for (auto it = p_conteneur.begin(); it != p_conteneur.end();){
+            if (it->second.getNbArrets() == 0) it = p_conteneur.erase(it);
+            else ++it;
+        }
+    }
+}
 
 //! \brief ajoute les lignes dans l'objet GTFS
 //! \param[in] p_nomFichier: le nom du fichier contenant les lignes
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier)
 {
-    //lire un ligne a la fois dans le files entré en parametre DONE
-    std::fstream nwfiles(p_nomFichier, ios::in);
-
-    if (!nwfiles.is_open()){
-        std::cerr << "error loading the files" <<endl;
-        return;
-    }
-    std::string line;
-    int line_count = 0;
-
-
-    while (std::getline(nwfiles, line)){
-        if (line_count > 0){
-            //for each line in the files we stock the lines data in a vector using the string_to_vector methode
-            vector <string> route = (string_to_vector(line, ','));
-
-            unsigned int p_id = stoi(route[0]);
-            const std::string route_numero = route[2];
-            const std::string route_description = route[4];
-            const CategorieBus route_categorie = Ligne::couleurToCategorie(route[7]); // Assuming 'couleurToCategorie' is a static function
-
-            //extract the important data in the vector and create an object line with the contructor ligne
-            Ligne ligne = Ligne(route[0], route_numero, route_description, route_categorie);
-
-            m_lignes.insert({route[0], ligne});
-            m_lignes_par_numero.insert({route_numero, ligne});
-
-        }
-        line_count++;
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> route;
+    lecteur.lireLigne(route); //en-tête
+
+    while (lecteur.lireLigne(route)){
+        verifierNbChamps(lecteur, route, 8);
+        const std::string route_id(route[0]);
+        const std::string route_numero(route[2]);
+        const std::string route_description(route[4]);
+        const CategorieBus route_categorie = Ligne::couleurToCategorie(std::string(route[7]));
+
+        //extract the important data and create an object line with the contructor ligne
+        Ligne ligne = Ligne(route_id, route_numero, route_description, route_categorie);
+
+        m_lignes.insert({route_id, ligne});
+        m_lignes_par_numero.insert({route_numero, ligne});
     }
-    nwfiles.close();
 }
 
 //! \brief ajoute les stations dans l'objet GTFS
@@ -48,27 +66,20 @@ void DonneesGTFS::ajouterLignes(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterStations(const std::string &p_nomFichier)
 {
-    fstream stationFiles(p_nomFichier, ios::in);
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> station_vec;
+    lecteur.lireLigne(station_vec); //en-tête
 
-    if (!stationFiles.is_open()){
-        std::cerr<<"error loading the files"<<endl;
-    }
-    std::string station;
-    int station_count = 0;
-
-    while (std::getline(stationFiles, station)){
-        if (station_count > 0){
-            vector <string> station_vec = string_to_vector(station, ',');
+    while (lecteur.lireLigne(station_vec)){
+        verifierNbChamps(lecteur, station_vec, 6);
+        const Coordonnees p_coord = Coordonnees(LecteurCSV::lireReel(station_vec[4]),
+                                                LecteurCSV::lireReel(station_vec[5]));
 
-            const Coordonnees p_coord = Coordonnees(stod(station_vec[4]), stod(station_vec[5]));
+        const std::string station_id(station_vec[0]);
+        Station stationO = Station(station_id, std::string(station_vec[2]), std::string(station_vec[3]), p_coord);
 
-            Station stationO = Station(station_vec[0], station_vec[2], station_vec[3], p_coord);
-
-            m_stations.insert({station_vec[0], stationO});
-        }
-        station_count++;
+        m_stations.insert({station_id, stationO});
     }
-    stationFiles.close();
 }
 
 //! \brief ajoute les transferts dans l'objet GTFS
@@ -81,37 +92,31 @@ void DonneesGTFS::ajouterStations(const std::string &p_nomFichier)
 //! \throws logic_error si tous les arrets de la date et de l'intervalle n'ont pas été ajoutés
 void DonneesGTFS::ajouterTransferts(const std::string &p_nomFichier)
 {
-    fstream transferFile(p_nomFichier, ios::in);
-    std::string transfer;
     if (!m_tousLesArretsPresents){
         std::cerr<<"Tout les arret de la date n'ont pas ete ajouté"<<endl;
     }
 
-    if (!transferFile.is_open()){
-        std::cerr<<"error loading the files"<<endl;
-    }
-
-    int transferCount = 0;
-
-    while(std::getline(transferFile, transfer)){
-        if (transferCount > 0){
-            vector <string> tranfer_V = string_to_vector(transfer, ',');
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> tranfer_V;
+    lecteur.lireLigne(tranfer_V); //en-tête
+    std::string from_id, to_id;
 
-            const string min_transfer_time = tranfer_V[3];
-            if (tranfer_V[3] == "0"){
-                tranfer_V[3] = "1";
-            }
-            if ((m_stations.find(tranfer_V[0]) != m_stations.end())
-                and (m_stations.find(tranfer_V[1]) != m_stations.end())){
+    while (lecteur.lireLigne(tranfer_V)){
+        verifierNbChamps(lecteur, tranfer_V, 4);
+        from_id.assign(tranfer_V[0].data(), tranfer_V[0].size());
+        to_id.assign(tranfer_V[1].data(), tranfer_V[1].size());
 
-                m_transferts.push_back(make_tuple(tranfer_V[0], tranfer_V[1], stoi(tranfer_V[3])));
-                m_stationsDeTransfert.insert(tranfer_V[0]);
-            }
+        unsigned int min_transfer_time = LecteurCSV::lireEntier(tranfer_V[3]);
+        if (min_transfer_time == 0){
+            min_transfer_time = 1;
         }
-        transferCount++;
+        if ((m_stations.find(from_id) != m_stations.end())
+            and (m_stations.find(to_id) != m_stations.end())){
 
+            m_transferts.push_back(make_tuple(from_id, to_id, min_transfer_time));
+            m_stationsDeTransfert.insert(from_id);
+        }
     }
-    transferFile.close();
 }
 
 
@@ -120,31 +125,26 @@ void DonneesGTFS::ajouterTransferts(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterServices(const std::string &p_nomFichier)
 {
-    //open files and see if problem happens etc...
-    fstream serviceFile(p_nomFichier, ios::in);
-    if (!serviceFile.is_open()){
-        std::cerr<<"error loading the files"<<endl;
-    }
-    //loop through the .txt file and select only the <1> exception type
-    std::string services;
-    int service_count = 0;
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> services_V;
+    lecteur.lireLigne(services_V); //en-tête
 
-    while (std::getline(serviceFile, services)){
-        if (service_count > 0){
-            vector <string> services_V = string_to_vector(services, ',');
+    //select only the <1> exception type
+    while (lecteur.lireLigne(services_V)){
+        verifierNbChamps(lecteur, services_V, 3);
 
-            std::string p_date = services_V[1];
-            unsigned int an = stoul(p_date.substr(0, 4));
-            unsigned int mois = stoul(p_date.substr(4, 2));
-            unsigned int jour = stoul(p_date.substr(6, 2));
+        std::string_view p_date = services_V[1];
+        if (p_date.size() != 8){
+            throw logic_error("ligne " + to_string(lecteur.getNumeroLigne()) + ": date invalide " + std::string(p_date));
+        }
+        unsigned int an = LecteurCSV::lireEntier(p_date.substr(0, 4));
+        unsigned int mois = LecteurCSV::lireEntier(p_date.substr(4, 2));
+        unsigned int jour = LecteurCSV::lireEntier(p_date.substr(6, 2));
 
-            if (services_V[2] == "1" && Date(an, mois, jour) == m_date){
-                m_services.insert(services_V[0]);
-            }
+        if (services_V[2] == "1" && Date(an, mois, jour) == m_date){
+            m_services.insert(std::string(services_V[0]));
         }
-        service_count++;
     }
-    serviceFile.close();
 }
 
 //! \brief ajoute les voyages de la date
@@ -153,112 +153,144 @@ void DonneesGTFS::ajouterServices(const std::string &p_nomFichier)
 //! \throws logic_error si un problème survient avec la lecture du fichier
 void DonneesGTFS::ajouterVoyagesDeLaDate(const std::string &p_nomFichier)
 {
-    fstream VoyageFiles(p_nomFichier, ios::in);
-
-    if (!VoyageFiles.is_open()){
-        std::cerr<<"error loading the files"<<endl;
-    }
-    std::string service;
-    int count = 0;
-
-    while (std::getline(VoyageFiles, service)){
-        if (count > 0){
-            vector <string> station_vec = string_to_vector(service, ',');
-
-            const string p_id = (station_vec[0]);
-            std::string p_ligne = station_vec[3];
-            std::string p_serv = station_vec[1];
-            std::string p_dst = station_vec[4];
-
-            unsigned int year = stoul(p_serv.substr(0,4));
-            unsigned int month = stoul(p_serv.substr(4,2));
-            unsigned int d = stoul(p_serv.substr(6,2));
-            Date date = Date(year, month, d);
-
-            for (auto it = m_services.begin(); it != m_services.end(); it++){
-                if (it->compare(p_serv) == 0){
-                    Voyage voyage = Voyage(p_ligne, p_id, p_serv, p_dst);
-                    m_voyages.insert({p_ligne, voyage});
-                }
-            }
-
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> station_vec;
+    lecteur.lireLigne(station_vec); //en-tête
+    std::string p_serv;
+
+    while (lecteur.lireLigne(station_vec)){
+        verifierNbChamps(lecteur, station_vec, 5);
+        p_serv.assign(station_vec[1].data(), station_vec[1].size());
+
+        if (m_services.find(p_serv) != m_services.end()){
+            const std::string p_id(station_vec[0]);
+            const std::string p_ligne(station_vec[3]);
+            Voyage voyage = Voyage(p_ligne, p_id, p_serv, std::string(station_vec[4]));
+            m_voyages.insert({p_ligne, voyage});
         }
-        count++;
     }
-    VoyageFiles.close();
 }
 
 //! \brief ajoute les arrets aux voyages présents dans le GTFS si l'heure du voyage appartient à l'intervalle de temps du GTFS
 //! \brief Un arrêt est ajouté SSI son heure de départ est >= now1 et que son heure d'arrivée est < now2
 //! \brief De plus, on enlève les voyages qui n'ont pas d'arrêts dans l'intervalle de temps du GTFS
 //! \brief De plus, on enlève les stations qui n'ont pas d'arrets dans l'intervalle de temps du GTFS
-//! \param[in] p_nomFichier: le nom du fichier contenant les arrets
+//! \brief Le fichier est analysé en parallèle par morceaux, puis les arrêts sont ajoutés dans l'ordre du fichier
+//! \brief Un instantané écrit par InstantaneArrets::sauvegarder() est reconnu à sa signature et relu sans analyse
+//! \brief du texte; ses arrêts sont déjà filtrés
+//! \param[in] p_nomFichier: le nom du fichier contenant les arrets, ou d'un instantané
 //! \post assigne m_tousLesArretsPresents à true
-//! \throws logic_error si un problème survient avec la lecture du fichier
+//! \throws logic_error si un problème survient avec la lecture du fichier; un instantané corrompu ou dont un voyage
+//! \throws est absent est rejeté avant toute modification
 void DonneesGTFS::ajouterArretsDesVoyagesDeLaDate(const std::string &p_nomFichier)
 {
-    fstream files(p_nomFichier, ios::in);
-    if (!files.is_open()){
-        cerr<<"Error loading the files"<<endl;
-    }
-    std::string date;
-    int lineCount = 0;
-
-    while(getline(files, date)){
-        if (lineCount > 0){
-            vector <string> vectorr = string_to_vector(date, ',');
-
-
-            int hour_arv = stoi(vectorr[1].substr(0,2));
-            int min_arv = stoi(vectorr[1].substr(3,2));
-            int sec_arv = stoi(vectorr[1].substr(6,2));
-
-            int hour_dep = stoi(vectorr[2].substr(0,2));
-            int min_dep = stoi(vectorr[2].substr(3,2));
-            int sec_dep = stoi(vectorr[2].substr(6,2));
-
-
-
-            if (m_voyages.find(vectorr[0]) != m_voyages.end()){
-                Heure heure_ar = Heure(hour_arv, min_arv, sec_arv);
-                Heure heure_dep = Heure(hour_dep, min_dep, sec_dep);
+    if (InstantaneArrets::estInstantane(p_nomFichier)){
+        const InstantaneArrets instantane(p_nomFichier);
+        vector<Voyage *> voyages;
+        voyages.reserve(instantane.getIdVoyages().size());
+        for (const std::string &voyage_id : instantane.getIdVoyages()){
+            auto voyage = m_voyages.find(voyage_id);
+            if (voyage == m_voyages.end())
+                throw logic_error("instantané " + p_nomFichier + ": voyage absent " + voyage_id);
+            voyages.push_back(&voyage->second);
+        }
 
-                if (m_now2 > heure_ar and heure_dep >= m_now1){
-                    Arret::Ptr a_ptr = make_shared<Arret>(vectorr[3], heure_ar, heure_dep, stoi(vectorr[4]), vectorr[0]);
-                    m_voyages[vectorr[0]].ajouterArret(a_ptr);
-                    m_stations[vectorr[3]].addArret(a_ptr);
-                    ++m_nbArrets;
-                }
+        //les arrêts sont créés voyage par voyage, comme dans stop_times.txt, puis ajoutés aux stations dans l'ordre
+        //de leur multimap
+        const auto &arrets = instantane.getArrets();
+        const auto &debutArretsVoyages = instantane.getDebutArretsVoyages();
+        vector<Arret::Ptr> arretsCrees(arrets.size());
+        for (size_t v = 0; v < voyages.size(); ++v){
+            for (uint32_t k = debutArretsVoyages[v]; k < debutArretsVoyages[v + 1]; ++k){
+                const InstantaneArrets::ArretStocke &arret = arrets[k];
+                arretsCrees[k] = make_shared<Arret>(instantane.getIdStations()[arret.station],
+                                                    Heure(arret.arrivee / 3600, arret.arrivee / 60 % 60, arret.arrivee % 60),
+                                                    Heure(arret.depart / 3600, arret.depart / 60 % 60, arret.depart % 60),
+                                                    arret.sequence, instantane.getIdVoyages()[v]);
+                voyages[v]->ajouterArret(arretsCrees[k]);
             }
         }
-        lineCount++;
+        const auto &debutArretsStations = instantane.getDebutArretsStations();
+        for (size_t s = 0; s < instantane.getIdStations().size(); ++s){
+            Station &station = m_stations[instantane.getIdStations()[s]];
+            for (uint32_t k = debutArretsStations[s]; k < debutArretsStations[s + 1]; ++k){
+                station.addArret(arretsCrees[instantane.getArretsParStation()[k]]);
+                ++m_nbArrets;
+            }
+        }
+        retirerSansArrets(m_voyages);
+        retirerSansArrets(m_stations);
+        m_tousLesArretsPresents = true;
+        return;
     }
-    for (auto it = m_voyages.begin(); it != m_voyages.end();) {
-        if( it -> second.getNbArrets() == 0)
+
+    LecteurCSV lecteur(p_nomFichier);
+    vector<string_view> entete;
+    lecteur.lireLigne(entete);
+
+    //le fichier est découpé en morceaux de lignes complètes analysés et filtrés en parallèle;
+    //m_voyages n'est que consulté pendant cette phase
+    const size_t nbFils = max<size_t>(1, min<size_t>(thread::hardware_concurrency(),
+                                                     lecteur.getTailleRestante() / tailleMinMorceau));
+    const vector<MorceauCSV> morceaux = lecteur.decouper(nbFils);
+    const size_t nbMorceaux = morceaux.size();
+    vector<vector<ArretLu> > arretsLus(nbMorceaux);
+    vector<exception_ptr> erreurs(nbMorceaux);
+
+    auto analyserMorceau = [&](size_t p_morceau)
+    {
+        try
         {
-            it = m_voyages.erase(it);
+            LecteurCSV morceau(lecteur, morceaux[p_morceau]);
+            vector<string_view> vectorr;
+            std::string voyage_id;
+            while (morceau.lireLigne(vectorr)){
+                verifierNbChamps(morceau, vectorr, 5);
+                voyage_id.assign(vectorr[0].data(), vectorr[0].size());
+
+                auto voyage = m_voyages.find(voyage_id);
+                if (voyage != m_voyages.end()){
+                    unsigned int hour_arv, min_arv, sec_arv;
+                    unsigned int hour_dep, min_dep, sec_dep;
+                    LecteurCSV::lireHeure(vectorr[1], hour_arv, min_arv, sec_arv);
+                    LecteurCSV::lireHeure(vectorr[2], hour_dep, min_dep, sec_dep);
+                    Heure heure_ar = Heure(hour_arv, min_arv, sec_arv);
+                    Heure heure_dep = Heure(hour_dep, min_dep, sec_dep);
+
+                    if (m_now2 > heure_ar and heure_dep >= m_now1){
+                        Arret::Ptr a_ptr = make_shared<Arret>(std::string(vectorr[3]), heure_ar, heure_dep,
+                                                              LecteurCSV::lireEntier(vectorr[4]), voyage_id);
+                        arretsLus[p_morceau].push_back({&voyage->second, a_ptr});
+                    }
+                }
+            }
         }
-        else
+        catch (...)
         {
-            ++it;
+            erreurs[p_morceau] = current_exception();
         }
+    };
+
+    vector<thread> fils;
+    for (size_t i = 1; i < nbMorceaux; ++i) fils.emplace_back(analyserMorceau, i);
+    analyserMorceau(0);
+    for (auto &fil : fils) fil.join();
+    for (const auto &erreur : erreurs){
+        if (erreur) rethrow_exception(erreur);
     }
 
-    for (auto itt = m_stations.begin(); itt != m_stations.end(); ) {
-        if( itt -> second.getNbArrets() == 0)
-        {
-            itt = m_stations.erase(itt);
-        }
-
-        else
-        {
-            ++itt;
+    //fusion dans l'ordre du fichier: les arrêts des voyages et des stations sont ajoutés comme par une lecture séquentielle
+    for (auto &morceau : arretsLus){
+        for (auto &arretLu : morceau){
+            arretLu.voyage->ajouterArret(arretLu.arret);
+            m_stations[arretLu.arret->getStationId()].addArret(arretLu.arret);
+            ++m_nbArrets;
         }
+        vector<ArretLu>().swap(morceau);
     }
-    files.close();
+
+    retirerSansArrets(m_voyages);
+    retirerSansArrets(m_stations);
 
     m_tousLesArretsPresents = true;
 }
-
-
-
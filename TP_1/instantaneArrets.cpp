@@ -0,0 +1,308 @@
+//
+//  InstantaneArrets.cpp
+//  Instantané binaire des arrêts retenus par DonneesGTFS pour une date et un intervalle de temps
+//
+
+#include "instantaneArrets.h"
+#include "DonneesGTFS.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace
+{
+    //! \brief en-tête d'un instantané, suivi des sections (voir InstantaneArrets::sauvegarder())
+    struct EnTeteArrets
+    {
+        char magie[8];
+        uint32_t version;
+        uint32_t reserve;
+        uint64_t cle;
+        uint64_t nbVoyages;
+        uint64_t nbStations;
+        uint64_t nbArrets;
+        uint64_t tailleIdentifiants;
+    };
+
+    const char magieArrets[8] = {'A', 'R', 'R', 'E', 'T', 'S', 'P', '1'};
+
+    //! \brief fichiers lus par DonneesGTFS, dont dépendent les instantanés
+    const char *const fichiersGTFS[] = {"routes.txt", "stops.txt", "calendar_dates.txt", "trips.txt",
+                                        "stop_times.txt", "transfers.txt"};
+
+    //! \return vrai si l'en-tête de p_fichier a pu être lu et porte la signature d'un instantané
+    bool lireEnTete(const string &p_fichier, EnTeteArrets &p_enTete)
+    {
+        ifstream flux(p_fichier, ios::binary);
+        return flux.read(reinterpret_cast<char *>(&p_enTete), sizeof(p_enTete)) &&
+               memcmp(p_enTete.magie, magieArrets, sizeof(magieArrets)) == 0;
+    }
+
+    //! \throws logic_error si p_flux n'a pas pu lire p_nombre éléments
+    template<typename T>
+    void lireSection(istream &p_flux, size_t p_nombre, vector<T> &p_tableau)
+    {
+        p_tableau.resize(p_nombre);
+        if (!p_flux.read(reinterpret_cast<char *>(p_tableau.data()), p_nombre * sizeof(T)))
+            throw logic_error("InstantaneArrets: instantané tronqué");
+    }
+
+    //! \brief découpe p_texte en p_nombre identifiants terminés par un zéro, à partir de p_position
+    //! \throws logic_error s'il en manque
+    void lireIdentifiants(const vector<char> &p_texte, size_t &p_position, size_t p_nombre,
+                          vector<string> &p_identifiants)
+    {
+        p_identifiants.reserve(p_nombre);
+        for (size_t i = 0; i < p_nombre; ++i)
+        {
+            auto fin = find(p_texte.begin() + p_position, p_texte.end(), '\0');
+            if (fin == p_texte.end()) throw logic_error("InstantaneArrets: identifiants tronqués");
+            p_identifiants.emplace_back(p_texte.begin() + p_position, fin);
+            p_position = static_cast<size_t>(fin - p_texte.begin()) + 1;
+        }
+    }
+
+    //! \return vrai si p_debuts est un tableau de débuts de plages croissant de 0 à p_fin
+    bool debutsValides(const vector<uint32_t> &p_debuts, size_t p_fin)
+    {
+        return p_debuts.front() == 0 && p_debuts.back() == p_fin && is_sorted(p_debuts.begin(), p_debuts.end());
+    }
+}
+
+//! \brief relit et vérifie un instantané; sa clé n'est pas vérifiée (voir ajouterArrets())
+//! \param[in] p_fichier: le nom du fichier de l'instantané
+//! \throws logic_error si le fichier n'est pas un instantané de cette version ou s'il est corrompu
+InstantaneArrets::InstantaneArrets(const string &p_fichier)
+{
+    ifstream flux(p_fichier, ios::binary);
+    EnTeteArrets enTete;
+    if (!flux.read(reinterpret_cast<char *>(&enTete), sizeof(enTete)) ||
+        memcmp(enTete.magie, magieArrets, sizeof(magieArrets)) != 0 || enTete.version != version)
+        throw logic_error("InstantaneArrets: " + p_fichier + " n'est pas un instantané de la version " +
+                          to_string(version));
+    flux.seekg(0, ios::end);
+    const uint64_t taille = static_cast<uint64_t>(flux.tellg()) - sizeof(enTete);
+    flux.seekg(sizeof(enTete));
+    if (enTete.nbVoyages >= taille || enTete.nbStations >= taille || enTete.nbArrets >= taille ||
+        enTete.tailleIdentifiants > taille ||
+        (enTete.nbVoyages + enTete.nbStations + 2 + enTete.nbArrets) * sizeof(uint32_t) +
+        enTete.nbArrets * sizeof(ArretStocke) + enTete.tailleIdentifiants != taille)
+        throw logic_error("InstantaneArrets: taille de l'instantané " + p_fichier + " incohérente avec son en-tête");
+
+    vector<char> identifiants;
+    lireSection(flux, enTete.nbVoyages + 1, m_debutArretsVoyages);
+    lireSection(flux, enTete.nbArrets, m_arrets);
+    lireSection(flux, enTete.nbStations + 1, m_debutArretsStations);
+    lireSection(flux, enTete.nbArrets, m_arretsParStation);
+    lireSection(flux, enTete.tailleIdentifiants, identifiants);
+
+    size_t position = 0;
+    lireIdentifiants(identifiants, position, enTete.nbVoyages, m_idVoyages);
+    lireIdentifiants(identifiants, position, enTete.nbStations, m_idStations);
+    if (!debutsValides(m_debutArretsVoyages, m_arrets.size()) || !debutsValides(m_debutArretsStations, m_arrets.size()))
+        throw logic_error("InstantaneArrets: plages incohérentes dans " + p_fichier);
+
+    //chaque arrêt doit être désigné une seule fois, par sa station
+    vector<uint8_t> designe(m_arrets.size(), 0);
+    for (size_t s = 0; s < m_idStations.size(); ++s)
+    {
+        for (uint32_t k = m_debutArretsStations[s]; k < m_debutArretsStations[s + 1]; ++k)
+        {
+            const uint32_t arret = m_arretsParStation[k];
+            if (arret >= m_arrets.size() || designe[arret] || m_arrets[arret].station != s)
+                throw logic_error("InstantaneArrets: arrêts des stations incohérents dans " + p_fichier);
+            designe[arret] = 1;
+        }
+    }
+}
+
+const vector<string> &InstantaneArrets::getIdVoyages() const
+{
+    return m_idVoyages;
+}
+
+const vector<string> &InstantaneArrets::getIdStations() const
+{
+    return m_idStations;
+}
+
+const vector<uint32_t> &InstantaneArrets::getDebutArretsVoyages() const
+{
+    return m_debutArretsVoyages;
+}
+
+const vector<InstantaneArrets::ArretStocke> &InstantaneArrets::getArrets() const
+{
+    return m_arrets;
+}
+
+const vector<uint32_t> &InstantaneArrets::getDebutArretsStations() const
+{
+    return m_debutArretsStations;
+}
+
+const vector<uint32_t> &InstantaneArrets::getArretsParStation() const
+{
+    return m_arretsParStation;
+}
+
+//! \return vrai si p_fichier commence par la signature d'un instantané, quelle que soit sa version
+bool InstantaneArrets::estInstantane(const string &p_fichier)
+{
+    EnTeteArrets enTete;
+    return lireEnTete(p_fichier, enTete);
+}
+
+//! \return vrai si p_fichier est un instantané de cette version et de clé p_cle
+bool InstantaneArrets::estAJour(const string &p_fichier, uint64_t p_cle)
+{
+    EnTeteArrets enTete;
+    return lireEnTete(p_fichier, enTete) && enTete.version == version && enTete.cle == p_cle;
+}
+
+//! \brief clé d'un instantané: version, date, intervalle de temps, ainsi que la taille et la date de modification
+//! \brief de chaque fichier GTFS; les données lues ne sont pas parcourues
+//! \param[in] p_gtfs: un objet DonneesGTFS, dont seuls la date et l'intervalle de temps sont consultés
+uint64_t InstantaneArrets::cle(const DonneesGTFS &p_gtfs, const string &p_repertoireGTFS)
+{
+    const Heure minuit(0, 0, 0);
+    Empreinte empreinte;
+    empreinte.ajouter(version);
+    ostringstream date;
+    date << p_gtfs.getDate();
+    empreinte.ajouter(date.str());
+    empreinte.ajouter(static_cast<uint32_t>(p_gtfs.getTempsDebut() - minuit));
+    empreinte.ajouter(static_cast<uint32_t>(p_gtfs.getTempsFin() - minuit));
+
+    for (const char *fichier : fichiersGTFS)
+    {
+        empreinte.ajouter(string(fichier));
+        struct stat infos;
+        if (stat((p_repertoireGTFS + "/" + fichier).c_str(), &infos) != 0)
+        {
+            empreinte.ajouter(numeric_limits<uint32_t>::max()); //fichier absent
+            continue;
+        }
+        const uint64_t attributs[3] = {static_cast<uint64_t>(infos.st_size), static_cast<uint64_t>(infos.st_mtim.tv_sec),
+                                       static_cast<uint64_t>(infos.st_mtim.tv_nsec)};
+        empreinte.ajouter(attributs, sizeof(attributs));
+    }
+    return empreinte.valeur();
+}
+
+//! \brief écrit les arrêts de p_gtfs dans un fichier temporaire puis le renomme, afin qu'un lecteur ne voie jamais
+//! \brief un instantané partiel
+//! \brief sections: débuts des arrêts de chaque voyage, arrêts groupés par voyage, débuts des arrêts de chaque
+//! \brief station, indices des arrêts de chaque station (dans l'ordre de sa multimap), puis identifiants des voyages
+//! \brief et des stations terminés par un zéro
+//! \pre p_gtfs contient tous ses arrêts
+//! \throws logic_error si un arrêt désigne un voyage absent ou si l'écriture échoue
+void InstantaneArrets::sauvegarder(const DonneesGTFS &p_gtfs, const string &p_fichier, uint64_t p_cle)
+{
+    const Heure minuit(0, 0, 0);
+    vector<string> idVoyages;
+    idVoyages.reserve(p_gtfs.getVoyages().size());
+    for (const auto &voyage : p_gtfs.getVoyages())
+        idVoyages.push_back(voyage.first);
+
+    //arrêts dans l'ordre des stations, puis regroupés par voyage
+    vector<ArretStocke> arretsParStation;
+    vector<uint32_t> voyageDeLArret;
+    vector<uint32_t> debutArretsStations(1, 0);
+    string identifiants;
+    for (const string &id : idVoyages)
+        identifiants.append(id).push_back('\0');
+    for (const auto &station : p_gtfs.getStations())
+    {
+        identifiants.append(station.first).push_back('\0');
+        for (const auto &arret : station.second.getArrets())
+        {
+            const string &idVoyage = arret.second->getVoyageId();
+            auto voyage = lower_bound(idVoyages.begin(), idVoyages.end(), idVoyage);
+            if (voyage == idVoyages.end() || *voyage != idVoyage)
+                throw logic_error("InstantaneArrets: voyage absent " + idVoyage);
+            voyageDeLArret.push_back(static_cast<uint32_t>(voyage - idVoyages.begin()));
+            arretsParStation.push_back({static_cast<uint32_t>(debutArretsStations.size() - 1),
+                                        static_cast<uint32_t>(arret.second->getNumeroSequence()),
+                                        static_cast<uint32_t>(arret.second->getHeureArrivee() - minuit),
+                                        static_cast<uint32_t>(arret.second->getHeureDepart() - minuit)});
+        }
+        debutArretsStations.push_back(static_cast<uint32_t>(arretsParStation.size()));
+    }
+
+    vector<uint32_t> ordre(arretsParStation.size());
+    iota(ordre.begin(), ordre.end(), 0);
+    stable_sort(ordre.begin(), ordre.end(), [&](uint32_t a, uint32_t b)
+    {
+        return voyageDeLArret[a] != voyageDeLArret[b] ? voyageDeLArret[a] < voyageDeLArret[b] :
+               arretsParStation[a].sequence < arretsParStation[b].sequence;
+    });
+    vector<ArretStocke> arrets(ordre.size());
+    vector<uint32_t> indices(ordre.size()); //indice dans arrets du k-ième arrêt dans l'ordre des stations
+    vector<uint32_t> debutArretsVoyages(idVoyages.size() + 1, 0);
+    for (uint32_t r = 0; r < ordre.size(); ++r)
+    {
+        arrets[r] = arretsParStation[ordre[r]];
+        indices[ordre[r]] = r;
+        ++debutArretsVoyages[voyageDeLArret[ordre[r]] + 1];
+    }
+    partial_sum(debutArretsVoyages.begin(), debutArretsVoyages.end(), debutArretsVoyages.begin());
+
+    EnTeteArrets enTete;
+    memcpy(enTete.magie, magieArrets, sizeof(magieArrets));
+    enTete.version = version;
+    enTete.reserve = 0;
+    enTete.cle = p_cle;
+    enTete.nbVoyages = idVoyages.size();
+    enTete.nbStations = debutArretsStations.size() - 1;
+    enTete.nbArrets = arrets.size();
+    enTete.tailleIdentifiants = identifiants.size();
+
+    const string temporaire = p_fichier + ".tmp";
+    {
+        ofstream flux(temporaire, ios::binary | ios::trunc);
+        flux.write(reinterpret_cast<const char *>(&enTete), sizeof(enTete));
+        flux.write(reinterpret_cast<const char *>(debutArretsVoyages.data()), debutArretsVoyages.size() * sizeof(uint32_t));
+        flux.write(reinterpret_cast<const char *>(arrets.data()), arrets.size() * sizeof(ArretStocke));
+        flux.write(reinterpret_cast<const char *>(debutArretsStations.data()), debutArretsStations.size() * sizeof(uint32_t));
+        flux.write(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(uint32_t));
+        flux.write(identifiants.data(), identifiants.size());
+        if (!flux) throw logic_error("InstantaneArrets: impossible d'écrire l'instantané " + temporaire);
+    }
+    if (rename(temporaire.c_str(), p_fichier.c_str()) != 0)
+        throw logic_error("InstantaneArrets: impossible de renommer l'instantané " + temporaire);
+}
+
+//! \brief ajoute à p_gtfs les arrêts de l'instantané p_fichierInstantane s'il correspond aux fichiers GTFS, sinon
+//! \brief ceux de p_repertoireGTFS/stop_times.txt, puis réécrit l'instantané
+//! \param[in] p_gtfs: un objet DonneesGTFS dont les voyages de la date ont été ajoutés
+//! \return vrai si les arrêts ont été relus de l'instantané
+//! \throws logic_error si la lecture du fichier texte ou l'écriture de l'instantané échoue
+bool InstantaneArrets::ajouterArrets(DonneesGTFS &p_gtfs, const string &p_repertoireGTFS,
+                                     const string &p_fichierInstantane)
+{
+    const uint64_t cleCourante = cle(p_gtfs, p_repertoireGTFS);
+    if (estAJour(p_fichierInstantane, cleCourante))
+    {
+        try
+        {
+            p_gtfs.ajouterArretsDesVoyagesDeLaDate(p_fichierInstantane);
+            return true;
+        }
+        catch (const logic_error &)
+        {
+            //instantané corrompu: il est vérifié avant que p_gtfs soit modifié, puis reconstruit ci-dessous
+        }
+    }
+    p_gtfs.ajouterArretsDesVoyagesDeLaDate(p_repertoireGTFS + "/stop_times.txt");
+    sauvegarder(p_gtfs, p_fichierInstantane, cleCourante);
+    return false;
+}
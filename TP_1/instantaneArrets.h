@@ -0,0 +1,96 @@
+//
+//  InstantaneArrets.h
+//  Instantané binaire des arrêts retenus par DonneesGTFS pour une date et un intervalle de temps
+//
+
+#ifndef INSTANTANEARRETS_H
+#define INSTANTANEARRETS_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class DonneesGTFS;
+
+//! \brief hachage FNV-1a 64 bits
+class Empreinte
+{
+public:
+    void ajouter(const void *p_donnees, size_t p_taille)
+    {
+        const unsigned char *octets = static_cast<const unsigned char *>(p_donnees);
+        for (size_t i = 0; i < p_taille; ++i)
+        {
+            m_valeur ^= octets[i];
+            m_valeur *= 1099511628211ULL;
+        }
+    }
+    void ajouter(const std::string &p_texte)
+    {
+        ajouter(p_texte.data(), p_texte.size() + 1); //avec le zéro terminal comme séparateur
+    }
+    void ajouter(uint32_t p_entier)
+    {
+        ajouter(&p_entier, sizeof(p_entier));
+    }
+    void ajouter(uint64_t p_entier)
+    {
+        ajouter(&p_entier, sizeof(p_entier));
+    }
+    uint64_t valeur() const
+    {
+        return m_valeur;
+    }
+private:
+    uint64_t m_valeur = 14695981039346656037ULL;
+};
+
+//! \brief Arrêts de stop_times.txt retenus par DonneesGTFS::ajouterArretsDesVoyagesDeLaDate(), groupés par voyage dans
+//! \brief l'ordre des séquences, avec pour chaque station la liste de ses arrêts dans l'ordre de sa multimap.
+//! \brief DonneesGTFS::ajouterArretsDesVoyagesDeLaDate() reconnaît un instantané à sa signature et le relit à la place
+//! \brief du fichier texte; les autres fichiers GTFS, petits, restent lus en texte. La clé d'un instantané périmé ne
+//! \brief correspond plus: il est alors ignoré et réécrit (voir ajouterArrets()).
+class InstantaneArrets
+{
+public:
+
+    //! \brief arrêt d'un voyage
+    struct ArretStocke
+    {
+        uint32_t station;  /*!< rang de l'identifiant de la station dans getIdStations() */
+        uint32_t sequence;
+        uint32_t arrivee;  /*!< en secondes depuis minuit */
+        uint32_t depart;   /*!< en secondes depuis minuit */
+    };
+
+    explicit InstantaneArrets(const std::string &p_fichier);
+
+    const std::vector<std::string> &getIdVoyages() const;
+    const std::vector<std::string> &getIdStations() const;
+    const std::vector<uint32_t> &getDebutArretsVoyages() const;
+    const std::vector<ArretStocke> &getArrets() const;
+    const std::vector<uint32_t> &getDebutArretsStations() const;
+    const std::vector<uint32_t> &getArretsParStation() const;
+
+    static bool estInstantane(const std::string &p_fichier);
+    static uint64_t cle(const DonneesGTFS &p_gtfs, const std::string &p_repertoireGTFS);
+    static void sauvegarder(const DonneesGTFS &p_gtfs, const std::string &p_fichier, uint64_t p_cle);
+    static bool ajouterArrets(DonneesGTFS &p_gtfs, const std::string &p_repertoireGTFS,
+                              const std::string &p_fichierInstantane);
+
+    static constexpr uint32_t version = 1; /*!< à incrémenter lorsque le format ou le filtrage des arrêts change */
+
+private:
+
+    static bool estAJour(const std::string &p_fichier, uint64_t p_cle);
+
+    std::vector<std::string> m_idVoyages;
+    std::vector<std::string> m_idStations;
+    std::vector<uint32_t> m_debutArretsVoyages;  /*!< nbVoyages + 1 débuts de plages dans m_arrets */
+    std::vector<ArretStocke> m_arrets;
+    std::vector<uint32_t> m_debutArretsStations; /*!< nbStations + 1 débuts de plages dans m_arretsParStation */
+    std::vector<uint32_t> m_arretsParStation;    /*!< indices dans m_arrets */
+};
+
+#endif //INSTANTANEARRETS_H
@@ -0,0 +1,214 @@
+//
+//  LecteurCSV.cpp
+//  Lecture sans copie des fichiers GTFS projetés en mémoire
+//
+
+#include "lecteurCSV.h"
+#include <stdexcept>
+#include <charconv>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+//! \brief projette le fichier en mémoire
+//! \param[in] p_nomFichier: le nom du fichier CSV
+//! \throws logic_error si le fichier ne peut pas être ouvert ou projeté
+LecteurCSV::LecteurCSV(const string &p_nomFichier)
+        : m_nomFichier(p_nomFichier), m_debut(nullptr), m_taille(0), m_position(0), m_numeroLigne(0),
+          m_proprietaire(true)
+{
+    int fd = open(p_nomFichier.c_str(), O_RDONLY);
+    if (fd < 0) throw logic_error("LecteurCSV: impossible d'ouvrir le fichier " + p_nomFichier);
+    struct stat infos;
+    if (fstat(fd, &infos) < 0)
+    {
+        close(fd);
+        throw logic_error("LecteurCSV: impossible de lire la taille du fichier " + p_nomFichier);
+    }
+    m_taille = static_cast<size_t>(infos.st_size);
+    if (m_taille > 0)
+    {
+        //projection privée: les guillemets doublés sont réécrits sur place sans toucher au fichier
+        void *projection = mmap(nullptr, m_taille, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (projection == MAP_FAILED)
+        {
+            close(fd);
+            throw logic_error("LecteurCSV: impossible de projeter le fichier " + p_nomFichier);
+        }
+        m_debut = static_cast<char *>(projection);
+        madvise(m_debut, m_taille, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    //marque d'ordre des octets UTF-8
+    if (m_taille >= 3 && m_debut[0] == '\xEF' && m_debut[1] == '\xBB' && m_debut[2] == '\xBF')
+        m_position = 3;
+}
+
+//! \brief sous-lecteur d'un morceau de la projection de p_fichier, tel que retourné par decouper()
+//! \brief les numéros de ligne d'un sous-lecteur sont ceux du fichier entier
+LecteurCSV::LecteurCSV(const LecteurCSV &p_fichier, const MorceauCSV &p_morceau)
+        : m_nomFichier(p_fichier.m_nomFichier), m_debut(p_fichier.m_debut), m_taille(p_morceau.fin),
+          m_position(p_morceau.debut), m_numeroLigne(p_morceau.numeroLigne), m_proprietaire(false)
+{
+    if (p_morceau.debut > p_morceau.fin || p_morceau.fin > p_fichier.m_taille)
+        throw logic_error("LecteurCSV: morceau invalide de " + m_nomFichier);
+}
+
+LecteurCSV::~LecteurCSV()
+{
+    if (m_debut && m_proprietaire) munmap(m_debut, m_taille);
+}
+
+//! \brief découpe le reste du fichier (à partir de la position courante) en morceaux de tailles semblables
+//! \brief dont chaque frontière est un début de ligne; un champ entre guillemets ne doit pas contenir de
+//! \brief saut de ligne
+//! \param[in] p_nbMorceaux: nombre de morceaux souhaité (moins si le fichier est trop petit)
+//! \return les morceaux consécutifs, avec le nombre de lignes qui précèdent chacun (sauts de ligne comptés
+//! \return jusqu'à sa frontière) pour que les sous-lecteurs rapportent les numéros de ligne du fichier
+vector<MorceauCSV> LecteurCSV::decouper(size_t p_nbMorceaux) const
+{
+    vector<MorceauCSV> morceaux(1, {m_position, m_taille, m_numeroLigne});
+    const size_t reste = m_taille - m_position;
+    for (size_t i = 1; i < p_nbMorceaux; ++i)
+    {
+        MorceauCSV &precedent = morceaux.back();
+        size_t frontiere = max(m_position + reste / p_nbMorceaux * i, precedent.debut);
+        while (frontiere < m_taille && frontiere > m_position && m_debut[frontiere - 1] != '\n') ++frontiere;
+        if (frontiere <= precedent.debut || frontiere >= m_taille) continue;
+        precedent.fin = frontiere;
+        const size_t numeroLigne = precedent.numeroLigne +
+                                   static_cast<size_t>(count(m_debut + precedent.debut, m_debut + frontiere, '\n'));
+        morceaux.push_back({frontiere, m_taille, numeroLigne});
+    }
+    return morceaux;
+}
+
+//! \brief découpe la prochaine ligne non vide du fichier en champs
+//! \param[out] p_champs: les champs de la ligne, valides tant que le lecteur existe
+//! \return false s'il ne reste plus de ligne à lire
+bool LecteurCSV::lireLigne(vector<string_view> &p_champs)
+{
+    p_champs.clear();
+    while (m_position < m_taille && (m_debut[m_position] == '\n' || m_debut[m_position] == '\r'))
+    {
+        if (m_debut[m_position] == '\n') ++m_numeroLigne;
+        ++m_position;
+    }
+    if (m_position >= m_taille) return false;
+    ++m_numeroLigne;
+
+    while (true)
+    {
+        if (m_position < m_taille && m_debut[m_position] == '"')
+        {
+            p_champs.push_back(lireChampEntreGuillemets());
+        }
+        else
+        {
+            const size_t debut = m_position;
+            while (m_position < m_taille && m_debut[m_position] != ',' && m_debut[m_position] != '\n' &&
+                   m_debut[m_position] != '\r')
+                ++m_position;
+            p_champs.emplace_back(m_debut + debut, m_position - debut);
+        }
+
+        if (m_position >= m_taille) return true;
+        const char separateur = m_debut[m_position++];
+        if (separateur == ',') continue;
+        if (separateur == '\r' && m_position < m_taille && m_debut[m_position] == '\n') ++m_position;
+        return true;
+    }
+}
+
+//! \brief lit un champ débutant par un guillemet; les guillemets doublés sont ramenés à un seul, sur place
+//! \throws logic_error si le guillemet fermant est absent
+string_view LecteurCSV::lireChampEntreGuillemets()
+{
+    const size_t debut = ++m_position;
+    size_t ecriture = debut;
+    while (true)
+    {
+        if (m_position >= m_taille)
+            throw logic_error("LecteurCSV: guillemet non fermé à la ligne " + to_string(m_numeroLigne) + " de " +
+                              m_nomFichier);
+        const char c = m_debut[m_position];
+        if (c == '"')
+        {
+            if (m_position + 1 < m_taille && m_debut[m_position + 1] == '"')
+            {
+                m_debut[ecriture++] = '"';
+                m_position += 2;
+                continue;
+            }
+            ++m_position;
+            break;
+        }
+        if (c == '\n') ++m_numeroLigne;
+        m_debut[ecriture++] = c;
+        ++m_position;
+    }
+    //caractères superflus entre le guillemet fermant et le séparateur
+    while (m_position < m_taille && m_debut[m_position] != ',' && m_debut[m_position] != '\n' &&
+           m_debut[m_position] != '\r')
+        ++m_position;
+    return string_view(m_debut + debut, ecriture - debut);
+}
+
+//! \return le numéro (à partir de 1) de la dernière ligne lue
+size_t LecteurCSV::getNumeroLigne() const
+{
+    return m_numeroLigne;
+}
+
+//! \return le nombre d'octets qu'il reste à lire
+size_t LecteurCSV::getTailleRestante() const
+{
+    return m_taille - m_position;
+}
+
+//! \brief convertit un champ formé uniquement de chiffres
+//! \throws logic_error si le champ est vide ou contient autre chose que des chiffres
+unsigned int LecteurCSV::lireEntier(string_view p_champ)
+{
+    if (p_champ.empty()) throw logic_error("LecteurCSV::lireEntier(): champ vide");
+    unsigned int valeur = 0;
+    for (char c : p_champ)
+    {
+        if (c < '0' || c > '9')
+            throw logic_error("LecteurCSV::lireEntier(): champ invalide: " + string(p_champ));
+        valeur = valeur * 10 + static_cast<unsigned int>(c - '0');
+    }
+    return valeur;
+}
+
+//! \brief convertit un champ en nombre réel (coordonnées)
+//! \throws logic_error si le champ n'est pas un nombre
+double LecteurCSV::lireReel(string_view p_champ)
+{
+    while (!p_champ.empty() && p_champ.front() == ' ') p_champ.remove_prefix(1);
+    if (!p_champ.empty() && p_champ.front() == '+') p_champ.remove_prefix(1);
+    double valeur = 0;
+    auto resultat = from_chars(p_champ.data(), p_champ.data() + p_champ.size(), valeur);
+    if (resultat.ec != errc() || p_champ.empty())
+        throw logic_error("LecteurCSV::lireReel(): champ invalide: " + string(p_champ));
+    return valeur;
+}
+
+//! \brief découpe une heure GTFS H:MM:SS ou HH:MM:SS (les heures peuvent dépasser 23)
+//! \throws logic_error si le champ n'a pas ce format
+void LecteurCSV::lireHeure(string_view p_champ, unsigned int &p_heures, unsigned int &p_minutes,
+                           unsigned int &p_secondes)
+{
+    while (!p_champ.empty() && p_champ.front() == ' ') p_champ.remove_prefix(1);
+    const size_t separateur = p_champ.find(':');
+    if (separateur == string_view::npos || p_champ.size() != separateur + 6 || p_champ[separateur + 3] != ':')
+        throw logic_error("LecteurCSV::lireHeure(): heure invalide: " + string(p_champ));
+    p_heures = lireEntier(p_champ.substr(0, separateur));
+    p_minutes = lireEntier(p_champ.substr(separateur + 1, 2));
+    p_secondes = lireEntier(p_champ.substr(separateur + 4, 2));
+}
@@ -0,0 +1,60 @@
+//
+//  LecteurCSV.h
+//  Lecture sans copie des fichiers GTFS projetés en mémoire
+//
+
+#ifndef LECTEURCSV_H
+#define LECTEURCSV_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+//! \brief Morceau de lignes complètes d'un fichier CSV, lu par un sous-lecteur
+struct MorceauCSV
+{
+    size_t debut;        /*!< position du premier octet du morceau */
+    size_t fin;          /*!< position qui suit le dernier octet du morceau */
+    size_t numeroLigne;  /*!< nombre de lignes du fichier qui précèdent le morceau */
+};
+
+//! \brief Lecteur de fichier CSV projeté en mémoire (mmap) qui découpe chaque ligne en champs string_view
+//! \brief pointant directement dans le fichier. Les champs entre guillemets sont acceptés: les guillemets
+//! \brief sont retirés et un guillemet doublé ("") est remplacé par un seul, sur place dans la projection
+//! \brief privée du fichier. Les champs ne sont valides que tant que le lecteur existe.
+//! \brief Un lecteur peut être découpé en morceaux de lignes complètes, lus chacun par un sous-lecteur
+//! \brief qui partage la projection (un sous-lecteur par fil d'exécution).
+class LecteurCSV
+{
+public:
+
+    explicit LecteurCSV(const std::string &p_nomFichier);
+    LecteurCSV(const LecteurCSV &p_fichier, const MorceauCSV &p_morceau);
+    ~LecteurCSV();
+    LecteurCSV(const LecteurCSV &) = delete;
+    LecteurCSV &operator=(const LecteurCSV &) = delete;
+
+    bool lireLigne(std::vector<std::string_view> &p_champs);
+    size_t getNumeroLigne() const;
+    size_t getTailleRestante() const;
+    std::vector<MorceauCSV> decouper(size_t p_nbMorceaux) const;
+
+    static unsigned int lireEntier(std::string_view p_champ);
+    static double lireReel(std::string_view p_champ);
+    static void lireHeure(std::string_view p_champ, unsigned int &p_heures, unsigned int &p_minutes,
+                          unsigned int &p_secondes);
+
+private:
+
+    std::string_view lireChampEntreGuillemets();
+
+    std::string m_nomFichier;
+    char *m_debut;
+    size_t m_taille;      /*!< fin de la zone lue par ce lecteur */
+    size_t m_position;
+    size_t m_numeroLigne; /*!< dans le fichier entier, aussi pour un sous-lecteur */
+    bool m_proprietaire;  /*!< false pour un sous-lecteur, qui ne libère pas la projection */
+};
+
+#endif //LECTEURCSV_H
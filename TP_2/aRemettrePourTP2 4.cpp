@@ -1,35 +1,62 @@
 
 
 #include "ReseauGTFS.h"
+#include "identifiantsGTFS.h"
 #include <sys/time.h>
 
 using namespace std;
 
+namespace {
+    //! \brief indice (IdentifiantsGTFS) du voyage de chaque sommet, reconstruit sans chaîne de caractères:
+    //! \brief ajouterArcsVoyages() numérote les sommets dans l'ordre des voyages de DonneesGTFS, qui est aussi celui
+    //! \brief des indices de IdentifiantsGTFS
+    //! \throws logic_error si les p_nbSommets sommets ne sont pas exactement les arrêts des voyages
+    vector<uint32_t> voyagesDesSommets(const DonneesGTFS &p_gtfs, size_t p_nbSommets) {
+        vector<uint32_t> voyageDuSommet;
+        voyageDuSommet.reserve(p_nbSommets);
+        uint32_t voyage = 0;
+        for (const auto &tripPair: p_gtfs.getVoyages()) {
+            voyageDuSommet.insert(voyageDuSommet.end(), tripPair.second.getArrets().size(), voyage);
+            ++voyage;
+        }
+        if (voyageDuSommet.size() != p_nbSommets)
+            throw logic_error("ReseauGTFS: les sommets ne correspondent pas aux arrêts des voyages");
+        return voyageDuSommet;
+    }
+}
+
 //! \brief ajout des arcs dus aux voyages
 //! \brief insère les arrêts (associés aux sommets) dans m_arretDuSommet et m_sommetDeArret
+//! \brief les sommets sont numérotés dans l'ordre des voyages de DonneesGTFS, donc des indices de IdentifiantsGTFS
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
 void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS &gtfs) {
     try {
+        //m_sommetDeArret est rempli d'un seul coup, à partir des arrêts triés, plutôt qu'en une recherche par arrêt
+        vector<pair<Arret::Ptr, size_t>> sommetsDesArrets;
+        sommetsDesArrets.reserve(gtfs.getNbArrets());
+
         for (const auto &tripPair: gtfs.getVoyages()) {
             m_origine_dest_ajoute = false;
             const auto &arrets = tripPair.second.getArrets();
 
             for (const auto &currentArret: arrets) {
-                m_sommetDeArret[currentArret] = m_arretDuSommet.size();
+                const size_t sommet = m_arretDuSommet.size();
+                sommetsDesArrets.emplace_back(currentArret, sommet);
 
                 if (m_origine_dest_ajoute) {
-                    auto origine = m_sommetDeArret[currentArret] - 1;
-                    auto destination = m_sommetDeArret[currentArret];
                     auto weight = currentArret->getHeureArrivee() - m_arretDuSommet.back()->getHeureArrivee();
 
-
-                    m_leGraphe.ajouterArc(origine, destination, weight);
+                    m_leGraphe.ajouterArc(sommet - 1, sommet, weight);
                 }
 
                 m_arretDuSommet.push_back(currentArret);
                 m_origine_dest_ajoute = true;
             }
         }
+
+        sort(sommetsDesArrets.begin(), sommetsDesArrets.end(),
+             [](const pair<Arret::Ptr, size_t> &a, const pair<Arret::Ptr, size_t> &b) { return a.first < b.first; });
+        m_sommetDeArret.insert(sommetsDesArrets.begin(), sommetsDesArrets.end());
     } catch (const exception &E) {
         cerr << "Erreur: une incohérence est détecté lors de l'ajout des arcs voyages" << E.what() << endl;
     }
@@ -40,28 +67,33 @@ void ReseauGTFS::ajouterArcsVoyages(const DonneesGTFS &gtfs) {
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
 void ReseauGTFS::ajouterArcsTransferts(const DonneesGTFS &gtfs) {
     try {
-        for (const auto &transfert : gtfs.getTransferts()) {
-            const auto &arretsStationA = gtfs.getStations().at(get<0>(transfert)).getArrets();
-            const auto &arretsStationB = gtfs.getStations().at(get<1>(transfert)).getArrets();
+        //les numéros de ligne sont comparés par leurs indices plutôt que par chaînes
+        const IdentifiantsGTFS identifiants(gtfs);
+        const vector<uint32_t> voyageDuSommet = voyagesDesSommets(gtfs, m_arretDuSommet.size());
+        vector<size_t> sommetsB;
+        vector<uint32_t> numeroDesArretsB;
+
+        for (const auto &transfert : identifiants.getTransferts()) {
+            const auto &arretsStationA = identifiants.station(transfert.stationDepart).getArrets();
+            const auto &arretsStationB = identifiants.station(transfert.stationArrivee).getArrets();
+
+            sommetsB.clear();
+            numeroDesArretsB.clear();
+            for (const auto &arretB : arretsStationB) {
+                sommetsB.push_back(m_sommetDeArret.at(arretB.second));
+                numeroDesArretsB.push_back(identifiants.numeroDuVoyage(voyageDuSommet[sommetsB.back()]));
+            }
 
             for (const auto &arretA : arretsStationA) {
-                string ligneA = gtfs.getVoyages().at(arretA.second->getVoyageId()).getLigne();
+                const size_t sommetA = m_sommetDeArret.at(arretA.second);
+                const uint32_t ligneA = identifiants.numeroDuVoyage(voyageDuSommet[sommetA]);
 
-                for (auto arretB = arretsStationB.lower_bound(arretA.second->getHeureArrivee().add_secondes(get<2>(transfert)));
-                     arretB != arretsStationB.end(); ++arretB) {
+                auto arretB = arretsStationB.lower_bound(arretA.second->getHeureArrivee().add_secondes(transfert.duree));
+                for (size_t rangB = distance(arretsStationB.begin(), arretB); arretB != arretsStationB.end(); ++arretB, ++rangB) {
                     auto poids = arretB->first - arretA.second->getHeureArrivee();
-                    unsigned int tempsMin = get<2>(transfert);
-
-                    if (poids >= tempsMin) {
-                        vector<string> lignesUniques = {gtfs.getLignes().at(ligneA).getNumero()};
-                        string ligneB = gtfs.getVoyages().at(arretB->second->getVoyageId()).getLigne();
-                        if (find(lignesUniques.begin(), lignesUniques.end(), gtfs.getLignes().at(ligneB).getNumero()) == lignesUniques.end()) {
-                            m_leGraphe.ajouterArc(m_sommetDeArret[arretA.second], m_sommetDeArret[arretB->second], poids);
-                            const string &bon_numero = gtfs.getLignes().at(ligneB).getNumero();
 
-
-                            lignesUniques.push_back(bon_numero);
-                        }
+                    if (poids >= static_cast<int>(transfert.duree) && ligneA != numeroDesArretsB[rangB]) {
+                        m_leGraphe.ajouterArc(sommetA, sommetsB[rangB], poids);
                     }
                 }
             }
@@ -73,35 +105,40 @@ void ReseauGTFS::ajouterArcsTransferts(const DonneesGTFS &gtfs) {
 
 
 //! \brief ajouts des arcs d'une station à elle-même pour les stations qui ne sont pas dans DonneesGTFS::m_stationsDeTransfert
+//! \brief Il s'agit de la dernière étape de construction: le graphe est ensuite figé (Graphe::figer())
 //! \throws logic_error si une incohérence est détecté lors de cette étape de construction du graphe
 void ReseauGTFS::ajouterArcsAttente(const DonneesGTFS &gtfs) {
     try {
-        for (const auto &station : gtfs.getStations()) {
-            const auto &stationId = station.first;
+        const IdentifiantsGTFS identifiants(gtfs);
+        const vector<uint32_t> voyageDuSommet = voyagesDesSommets(gtfs, m_arretDuSommet.size());
 
-            if (gtfs.getStationsDeTransfert().find(stationId) != gtfs.getStationsDeTransfert().end()) continue;
+        for (uint32_t station = 0; station < identifiants.getNbStations(); ++station) {
+            if (identifiants.estStationDeTransfert(station)) continue;
 
-            map<string, vector<Arret::Ptr>> lignesArrets;
+            //les lignes sont indicées dans l'ordre de DonneesGTFS::getLignes(), donc parcourues dans le même ordre
+            map<uint32_t, vector<size_t>> lignesSommets;
 
-            for (const auto &arret : station.second.getArrets()) {
-                const auto &voyageId = arret.second->getVoyageId();
-                const auto &ligneId = gtfs.getVoyages().at(voyageId).getLigne();
-                lignesArrets[ligneId].push_back(arret.second); //
+            for (const auto &arret : identifiants.station(station).getArrets()) {
+                const size_t sommet = m_sommetDeArret.at(arret.second);
+                lignesSommets[identifiants.ligneDuVoyage(voyageDuSommet[sommet])].push_back(sommet);
             }
 
-            for (const auto &ligneArrets : lignesArrets) {
-                for (size_t i = 0; i < ligneArrets.second.size(); ++i) {
-                    for (size_t j = i + 1; j < ligneArrets.second.size(); ++j) {
-                        unsigned int poids = ligneArrets.second[j]->getHeureArrivee() - ligneArrets.second[i]->getHeureArrivee();
+            for (const auto &ligneSommets : lignesSommets) {
+                const vector<size_t> &sommets = ligneSommets.second;
+                for (size_t i = 0; i < sommets.size(); ++i) {
+                    for (size_t j = i + 1; j < sommets.size(); ++j) {
+                        //les arrêts sont triés par heure de départ: l'arrivée en j peut précéder celle en i
+                        int poids = m_arretDuSommet[sommets[j]]->getHeureArrivee() - m_arretDuSommet[sommets[i]]->getHeureArrivee();
 
-                        if (poids >= delaisMinArcsAttente) {
-                            m_leGraphe.ajouterArc(m_sommetDeArret[ligneArrets.second[i]],
-                                                  m_sommetDeArret[ligneArrets.second[j]], poids);
+                        if (poids >= static_cast<int>(delaisMinArcsAttente)) {
+                            m_leGraphe.ajouterArc(sommets[i], sommets[j], poids);
                         }
                     }
                 }
             }
         }
+        //les arcs origine/destination ajoutés ensuite restent dans les listes d'adjacence
+        m_leGraphe.figer();
     } catch (const exception &e) {
         cerr << "Erreur lors de l'ajout des arcs d'attente : " << e.what() << endl;
     }
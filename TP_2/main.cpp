@@ -7,11 +7,29 @@
 
 #include "DonneesGTFS.h"
 #include "ReseauGTFS.h"
+#include "empreinteMemoire.h"
+#include "instantaneArrets.h"
 
 using namespace std;
 
-int main()
+//! \brief l'option --memoire affiche la mémoire occupée par les données et le réseau après leur construction
+//! \brief l'option --instantane <répertoire> relit les arrêts de l'instantané arrets.bin de ce répertoire s'il
+//! \brief correspond aux fichiers GTFS, sinon les lit en texte et l'y écrit; sans elle, aucun instantané n'est lu ni écrit
+int main(int argc, char *argv[])
 {
+    bool afficherMemoire = false;
+    std::string repertoireInstantanes; //vide: pas d'instantané
+    for (int i = 1; i < argc; ++i)
+    {
+        const string option = argv[i];
+        if (option == "--memoire") afficherMemoire = true;
+        else if (option == "--instantane" && i + 1 < argc) repertoireInstantanes = argv[++i];
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--memoire] [--instantane <répertoire>]" << endl;
+            return 1;
+        }
+    }
     const std::string chemin_dossier = "RTC-1aout-25nov";
 
     Date today(2022, 8, 3);
@@ -33,11 +51,16 @@ int main()
     cout << "Nombre de services = " << nb_services << endl;
     if (nb_services==0) throw logic_error("main(): On doit avoir nb_services > 0 pour continuer");
     donnees_rtc.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt");
-    donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    bool arretsRelus = false;
+    if (repertoireInstantanes.empty())
+        donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    else
+        arretsRelus = InstantaneArrets::ajouterArrets(donnees_rtc, chemin_dossier, repertoireInstantanes + "/arrets.bin");
     donnees_rtc.ajouterTransferts(chemin_dossier + "/transfers.txt");
 
     clock_t end = clock();
-    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes"
+         << (arretsRelus ? " (arrêts relus de l'instantané)" : "") << endl;
 
     cout << "Nombre de stations ayant au moins 1 arrêt = " << donnees_rtc.getNbStations() << endl;
     cout << "Nombre de transferts = " << donnees_rtc.getNbTransferts() << endl;
@@ -49,6 +72,14 @@ int main()
     end = clock();
     cout << "Le nombre d'arcs (sans le point origine et destination) est = " << reseau_rtc.getNbArcs() << endl;
     cout << "Graphe (sans le point origine et destination) a été produit en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    if (afficherMemoire)
+    {
+        RapportMemoire rapport;
+        rapport.ajouterDonnees(donnees_rtc);
+        rapport.ajouterReseauGTFS(reseau_rtc, donnees_rtc);
+        cout << endl;
+        rapport.afficher(cout);
+    }
 
     cout << endl;
     cout << "=============================================" << endl;
@@ -0,0 +1,205 @@
+//
+//  Benchmark.cpp
+//  Mesures répétables du chargement, de la construction des graphes et des requêtes d'itinéraires
+//
+//  Programme distinct de main.cpp: compiler benchmark.cpp à la place de main.cpp.
+//  usage: benchmark [dossier GTFS] [répétitions] [requêtes] [graine]
+//  Le résultat est écrit en CSV sur la sortie standard; la progression est écrite sur la sortie d'erreur.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+
+#include "DonneesGTFS.h"
+#include "ReseauGTFS.h"
+#include "reseauPartage.h"
+#include "moteurCSA.h"
+#include "moteurRAPTOR.h"
+
+using namespace std;
+
+namespace
+{
+    //! \brief durées (en microsecondes) des répétitions d'un cas et nombre d'unités traitées par répétition
+    struct Mesures
+    {
+        explicit Mesures(const string &p_cas) : cas(p_cas)
+        {
+        }
+
+        string cas;
+        vector<double> durees;
+        double unites = 1;
+    };
+
+    double microsecondes(chrono::steady_clock::time_point p_debut, chrono::steady_clock::time_point p_fin)
+    {
+        return chrono::duration<double, micro>(p_fin - p_debut).count();
+    }
+
+    //! \brief mesure p_fonction(), qui retourne le nombre d'unités traitées
+    void mesurer(Mesures &p_mesures, const function<size_t()> &p_fonction)
+    {
+        auto debut = chrono::steady_clock::now();
+        p_mesures.unites = static_cast<double>(p_fonction());
+        p_mesures.durees.push_back(microsecondes(debut, chrono::steady_clock::now()));
+    }
+
+    //! \brief centile au rang le plus proche d'un échantillon trié
+    double centile(const vector<double> &p_tries, double p_centile)
+    {
+        size_t rang = static_cast<size_t>(p_centile / 100.0 * static_cast<double>(p_tries.size()) + 0.999999);
+        return p_tries[min(max<size_t>(rang, 1), p_tries.size()) - 1];
+    }
+
+    void ecrireEntete()
+    {
+        cout << "cas,echantillons,min_us,p50_us,p90_us,p99_us,max_us,moyenne_us,unites,unites_par_s" << endl;
+    }
+
+    void ecrire(const Mesures &p_mesures)
+    {
+        if (p_mesures.durees.empty()) return;
+        vector<double> tries(p_mesures.durees);
+        sort(tries.begin(), tries.end());
+        const double moyenne = accumulate(tries.begin(), tries.end(), 0.0) / static_cast<double>(tries.size());
+        cout << fixed << setprecision(1) << p_mesures.cas << ',' << tries.size() << ',' << tries.front() << ','
+             << centile(tries, 50) << ',' << centile(tries, 90) << ',' << centile(tries, 99) << ',' << tries.back()
+             << ',' << moyenne << ',' << setprecision(0) << p_mesures.unites << ','
+             << (moyenne > 0 ? p_mesures.unites * 1e6 / moyenne : 0) << endl;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const string chemin_dossier = argc > 1 ? argv[1] : "RTC-1aout-25nov";
+    const unsigned int nbRepetitions = argc > 2 ? static_cast<unsigned int>(stoul(argv[2])) : 5;
+    const unsigned int nbRequetes = argc > 3 ? static_cast<unsigned int>(stoul(argv[3])) : 200;
+    const unsigned int graine = argc > 4 ? static_cast<unsigned int>(stoul(argv[4])) : 42;
+
+    const Date today(2022, 8, 3);
+    const Heure now1(7, 30, 0);
+    const Heure now2 = now1.add_secondes(72000);
+
+    //chargement: chaque répétition relit tous les fichiers dans un nouvel objet (chaque étape dépend des précédentes)
+    Mesures lignes("chargement.lignes"), stations("chargement.stations"), services("chargement.services"),
+            voyages("chargement.voyages"), arrets("chargement.arrets"), transferts("chargement.transferts");
+    for (unsigned int r = 0; r < nbRepetitions; ++r)
+    {
+        cerr << "chargement " << r + 1 << "/" << nbRepetitions << endl;
+        DonneesGTFS donnees(today, now1, now2);
+        mesurer(lignes, [&] { donnees.ajouterLignes(chemin_dossier + "/routes.txt"); return donnees.getNbLignes(); });
+        mesurer(stations, [&] { donnees.ajouterStations(chemin_dossier + "/stops.txt"); return donnees.getNbStations(); });
+        mesurer(services, [&] { donnees.ajouterServices(chemin_dossier + "/calendar_dates.txt"); return donnees.getNbServices(); });
+        mesurer(voyages, [&] { donnees.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt"); return donnees.getNbVoyages(); });
+        mesurer(arrets, [&] { donnees.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt"); return donnees.getNbArrets(); });
+        mesurer(transferts, [&] { donnees.ajouterTransferts(chemin_dossier + "/transfers.txt"); return donnees.getNbTransferts(); });
+    }
+
+    DonneesGTFS donnees_rtc(today, now1, now2);
+    donnees_rtc.ajouterLignes(chemin_dossier + "/routes.txt");
+    donnees_rtc.ajouterStations(chemin_dossier + "/stops.txt");
+    donnees_rtc.ajouterServices(chemin_dossier + "/calendar_dates.txt");
+    donnees_rtc.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt");
+    donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    donnees_rtc.ajouterTransferts(chemin_dossier + "/transfers.txt");
+
+    //construction des graphes et des moteurs (les arcs ne sont pas séparés par étape: celles-ci sont privées)
+    Mesures reseauGTFS("construction.ReseauGTFS"), reseauComplet("construction.ReseauPartage.complet"),
+            reseauLineaire("construction.ReseauPartage.lineaire"), csa("construction.MoteurCSA"),
+            raptor("construction.MoteurRAPTOR");
+    for (unsigned int r = 0; r < nbRepetitions; ++r)
+    {
+        cerr << "construction " << r + 1 << "/" << nbRepetitions << endl;
+        mesurer(reseauGTFS, [&] { return ReseauGTFS(donnees_rtc).getNbArcs(); });
+        mesurer(reseauComplet, [&] { return ReseauPartage(donnees_rtc, ModeAttente::Complet).getNbArcs(); });
+        mesurer(reseauLineaire, [&] { return ReseauPartage(donnees_rtc, ModeAttente::Lineaire).getNbArcs(); });
+        mesurer(csa, [&] { return MoteurCSA(donnees_rtc).getNbConnexions(); });
+        mesurer(raptor, [&] { return MoteurRAPTOR(donnees_rtc).getNbPatrons(); });
+    }
+
+    //requêtes: paires de stations tirées avec une graine fixe, identiques pour tous les algorithmes
+    vector<Coordonnees> coords;
+    for (const auto &station : donnees_rtc.getStations()) coords.push_back(station.second.getCoords());
+    vector<pair<Coordonnees, Coordonnees> > requetes;
+    mt19937 generateur(graine);
+    uniform_int_distribution<size_t> distribution(0, coords.empty() ? 0 : coords.size() - 1);
+    for (unsigned int i = 0; i < nbRequetes && !coords.empty(); ++i)
+        requetes.emplace_back(coords[distribution(generateur)], coords[distribution(generateur)]);
+
+    cerr << "requêtes" << endl;
+    ReseauGTFS reseau_gtfs(donnees_rtc);
+    const IdentifiantsGTFS identifiants(donnees_rtc);
+    const ReseauPartage reseau_partage(donnees_rtc, identifiants, donnees_rtc.getTempsDebut(),
+                                       donnees_rtc.getTempsFin());
+    const MoteurCSA moteur_csa(donnees_rtc, identifiants);
+    const MoteurRAPTOR moteur_raptor(donnees_rtc, identifiants);
+    Mesures requeteGTFS("requete.ReseauGTFS"), requeteDijkstra("requete.ReseauPartage.dijkstra"),
+            requeteAEtoile("requete.ReseauPartage.aEtoile"), requeteCSA("requete.MoteurCSA"),
+            requeteRAPTOR("requete.MoteurRAPTOR");
+    ContexteItineraire contexteDijkstra, contexteAEtoile;
+    contexteDijkstra.aEtoile = false;
+    ContexteCSA contexteCSA;
+    ContexteRAPTOR contexteRAPTOR;
+    vector<OptionRAPTOR> options;
+    long tempsExecution;
+    double sommetsDijkstra = 0, sommetsAEtoile = 0; //si statistiquesRechercheActives
+    for (const auto &requete : requetes)
+    {
+        mesurer(requeteGTFS, [&]
+        {
+            reseau_gtfs.ajouterArcsOrigineDestination(donnees_rtc, requete.first, requete.second);
+            reseau_gtfs.itineraire(donnees_rtc, false, tempsExecution);
+            reseau_gtfs.enleverArcsOrigineDestination();
+            return 1;
+        });
+        mesurer(requeteDijkstra, [&]
+        {
+            reseau_partage.itineraire(donnees_rtc, requete.first, requete.second, false, tempsExecution,
+                                      contexteDijkstra);
+            sommetsDijkstra += static_cast<double>(contexteDijkstra.statistiques.sommetsTraites);
+            return 1;
+        });
+        mesurer(requeteAEtoile, [&]
+        {
+            reseau_partage.itineraire(donnees_rtc, requete.first, requete.second, false, tempsExecution,
+                                      contexteAEtoile);
+            sommetsAEtoile += static_cast<double>(contexteAEtoile.statistiques.sommetsTraites);
+            return 1;
+        });
+        mesurer(requeteCSA, [&]
+        {
+            moteur_csa.itineraire(donnees_rtc, requete.first, requete.second, false, tempsExecution, contexteCSA);
+            return 1;
+        });
+        mesurer(requeteRAPTOR, [&]
+        {
+            moteur_raptor.itineraires(donnees_rtc, requete.first, requete.second, 5, options, tempsExecution,
+                                      contexteRAPTOR);
+            return 1;
+        });
+    }
+
+    if (statistiquesRechercheActives && !requetes.empty())
+    {
+        cerr << "sommets traités par requête: Dijkstra " << sommetsDijkstra / requetes.size() << ", A* "
+             << sommetsAEtoile / requetes.size() << " (vitesse maximale des voyages "
+             << reseau_partage.getVitesseMaxReseau() << " km/h)" << endl;
+    }
+
+    //vérification reproductible (même graine): RAPTOR et CSA doivent donner les mêmes durées
+    cerr << "RAPTOR vs CSA: ";
+    MoteurRAPTOR::validerAvecCSA(donnees_rtc, nbRequetes, graine, cerr);
+
+    ecrireEntete();
+    for (const Mesures *mesures : {&lignes, &stations, &services, &voyages, &arrets, &transferts, &reseauGTFS,
+                                   &reseauComplet, &reseauLineaire, &csa, &raptor, &requeteGTFS, &requeteDijkstra,
+                                   &requeteAEtoile, &requeteCSA, &requeteRAPTOR})
+        ecrire(*mesures);
+    return 0;
+}
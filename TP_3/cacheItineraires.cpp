@@ -0,0 +1,174 @@
+//
+//  CacheItineraires.cpp
+//  Durées de trajet déjà calculées, par cellule d'origine, cellule de destination et tranche d'heure de départ
+//
+
+#include "cacheItineraires.h"
+#include "indexSpatial.h"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+//! \return la proportion des requêtes servies par le cache (0 si aucune requête)
+double StatistiquesCache::tauxSucces() const
+{
+    return succes + echecs == 0 ? 0.0 : static_cast<double>(succes) / static_cast<double>(succes + echecs);
+}
+
+ostream &operator<<(ostream &p_os, const StatistiquesCache &p_statistiques)
+{
+    p_os << p_statistiques.succes << " succès, " << p_statistiques.echecs << " échecs (taux de succès "
+         << 100.0 * p_statistiques.tauxSucces() << " %), " << p_statistiques.insertions << " insertions, "
+         << p_statistiques.evictions << " évictions, " << p_statistiques.invalidations << " invalidations, "
+         << p_statistiques.taille << " entrées";
+    return p_os;
+}
+
+//! \param[in] p_capacite: le nombre maximal d'entrées
+//! \param[in] p_tailleCellule: le côté d'une cellule de la grille en km
+//! \param[in] p_dureeTranche: la durée d'une tranche d'heures de départ en secondes
+//! \throws logic_error si un des paramètres est nul
+CacheItineraires::CacheItineraires(size_t p_capacite, double p_tailleCellule, unsigned int p_dureeTranche)
+        : m_capacite(p_capacite), m_pasLat(p_tailleCellule / IndexSpatial::kmParDegre), m_tailleCellule(p_tailleCellule),
+          m_dureeTranche(p_dureeTranche), m_version(0)
+{
+    if (p_capacite == 0 || !(p_tailleCellule > 0) || p_dureeTranche == 0)
+        throw logic_error("CacheItineraires::CacheItineraires(): la capacité, la taille des cellules et la durée "
+                          "des tranches doivent être positives");
+    m_index.reserve(p_capacite);
+}
+
+//! \brief cherche la durée d'une requête équivalente et la marque comme la plus récemment utilisée
+//! \param[in] p_version: la version du réseau interrogé
+//! \param[out] p_duree: la durée en cache, si elle existe
+//! \return vrai si la durée a été trouvée; une requête posée à un réseau déjà remplacé n'est jamais servie
+bool CacheItineraires::chercher(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                uint32_t p_heureDepart, uint64_t p_version, unsigned int &p_duree)
+{
+    const Cle cle = construireCle(p_pointOrigine, p_pointDestination, p_heureDepart);
+    lock_guard<mutex> verrou(m_verrou);
+    auto trouve = p_version == m_version ? m_index.find(cle) : m_index.end();
+    if (trouve == m_index.end())
+    {
+        ++m_statistiques.echecs;
+        return false;
+    }
+    m_entrees.splice(m_entrees.begin(), m_entrees, trouve->second);
+    p_duree = trouve->second->duree;
+    ++m_statistiques.succes;
+    return true;
+}
+
+//! \brief ajoute (ou remplace) la durée d'une requête; l'entrée la moins récemment utilisée est retirée si la
+//! \brief capacité est dépassée
+//! \param[in] p_version: la version du réseau qui a calculé p_duree; ignorée si ce réseau a été remplacé depuis
+void CacheItineraires::inserer(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                               uint32_t p_heureDepart, uint64_t p_version, unsigned int p_duree)
+{
+    const Cle cle = construireCle(p_pointOrigine, p_pointDestination, p_heureDepart);
+    lock_guard<mutex> verrou(m_verrou);
+    if (p_version != m_version) return;
+    auto trouve = m_index.find(cle);
+    if (trouve != m_index.end())
+    {
+        trouve->second->duree = p_duree;
+        m_entrees.splice(m_entrees.begin(), m_entrees, trouve->second);
+        return;
+    }
+    m_entrees.push_front({cle, p_duree});
+    m_index.emplace(cle, m_entrees.begin());
+    ++m_statistiques.insertions;
+    if (m_entrees.size() > m_capacite)
+    {
+        m_index.erase(m_entrees.back().cle);
+        m_entrees.pop_back();
+        ++m_statistiques.evictions;
+    }
+}
+
+//! \brief retire toutes les entrées: le réseau de version p_version ne donne plus les mêmes durées
+void CacheItineraires::invalider(uint64_t p_version)
+{
+    lock_guard<mutex> verrou(m_verrou);
+    m_statistiques.invalidations += m_entrees.size();
+    m_entrees.clear();
+    m_index.clear();
+    m_version = p_version;
+}
+
+//! \brief le réseau de version p_version ne diffère du précédent que par son intervalle de temps, qui débute
+//! \brief maintenant à p_heureDepart: seules les entrées de la tranche de p_heureDepart sont conservées
+void CacheItineraires::changerFenetre(uint64_t p_version, uint32_t p_heureDepart)
+{
+    const uint32_t tranche = p_heureDepart / m_dureeTranche;
+    lock_guard<mutex> verrou(m_verrou);
+    for (auto entree = m_entrees.begin(); entree != m_entrees.end();)
+    {
+        if (entree->cle.tranche == tranche)
+        {
+            ++entree;
+            continue;
+        }
+        m_index.erase(entree->cle);
+        entree = m_entrees.erase(entree);
+        ++m_statistiques.invalidations;
+    }
+    m_version = p_version;
+}
+
+StatistiquesCache CacheItineraires::getStatistiques() const
+{
+    lock_guard<mutex> verrou(m_verrou);
+    StatistiquesCache statistiques = m_statistiques;
+    statistiques.taille = m_entrees.size();
+    return statistiques;
+}
+
+size_t CacheItineraires::getCapacite() const
+{
+    return m_capacite;
+}
+
+bool CacheItineraires::Cle::operator==(const Cle &p_autre) const
+{
+    return ligneOrigine == p_autre.ligneOrigine && colonneOrigine == p_autre.colonneOrigine &&
+           ligneDestination == p_autre.ligneDestination && colonneDestination == p_autre.colonneDestination &&
+           tranche == p_autre.tranche;
+}
+
+size_t CacheItineraires::HachageCle::operator()(const Cle &p_cle) const
+{
+    //mélange de type FNV-1a des cinq champs
+    uint64_t h = 14695981039346656037ULL;
+    for (uint32_t champ : {static_cast<uint32_t>(p_cle.ligneOrigine), static_cast<uint32_t>(p_cle.colonneOrigine),
+                           static_cast<uint32_t>(p_cle.ligneDestination),
+                           static_cast<uint32_t>(p_cle.colonneDestination), p_cle.tranche})
+    {
+        h ^= champ;
+        h *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(h ^ (h >> 32));
+}
+
+CacheItineraires::Cle CacheItineraires::construireCle(const Coordonnees &p_pointOrigine,
+                                                      const Coordonnees &p_pointDestination,
+                                                      uint32_t p_heureDepart) const
+{
+    Cle cle;
+    cellule(p_pointOrigine, cle.ligneOrigine, cle.colonneOrigine);
+    cellule(p_pointDestination, cle.ligneDestination, cle.colonneDestination);
+    cle.tranche = p_heureDepart / m_dureeTranche;
+    return cle;
+}
+
+//! \brief cellule d'un point: les lignes ont une hauteur de m_tailleCellule km et chaque ligne est découpée en
+//! \brief colonnes d'environ m_tailleCellule km à la latitude de son centre
+void CacheItineraires::cellule(const Coordonnees &p_point, int32_t &p_ligne, int32_t &p_colonne) const
+{
+    p_ligne = static_cast<int32_t>(floor(p_point.getLatitude() / m_pasLat));
+    const double cosLat = max(cos((p_ligne + 0.5) * m_pasLat * IndexSpatial::degreEnRadian), 0.01);
+    p_colonne = static_cast<int32_t>(floor(p_point.getLongitude() * IndexSpatial::kmParDegre * cosLat /
+                                           m_tailleCellule));
+}
@@ -0,0 +1,96 @@
+//
+//  CacheItineraires.h
+//  Durées de trajet déjà calculées, par cellule d'origine, cellule de destination et tranche d'heure de départ
+//
+
+#ifndef CACHEITINERAIRES_H
+#define CACHEITINERAIRES_H
+
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <cstdint>
+
+#include "DonneesGTFS.h"
+
+//! \brief Compteurs d'un CacheItineraires depuis sa construction
+struct StatistiquesCache
+{
+    size_t succes = 0;        /*!< requêtes servies par le cache */
+    size_t echecs = 0;        /*!< requêtes absentes du cache (ou posées à un réseau déjà remplacé) */
+    size_t insertions = 0;
+    size_t evictions = 0;     /*!< entrées retirées pour respecter la capacité (les moins récemment utilisées) */
+    size_t invalidations = 0; /*!< entrées retirées parce que le réseau ou l'intervalle de temps a changé */
+    size_t taille = 0;        /*!< nombre d'entrées actuellement dans le cache */
+
+    double tauxSucces() const;
+};
+
+std::ostream &operator<<(std::ostream &p_os, const StatistiquesCache &p_statistiques);
+
+//! \brief Cache LRU borné des durées de trajet, partagé par les fils d'exécution qui interrogent un même réseau
+//! \brief La clé est (cellule du point origine, cellule du point destination, tranche de l'heure de départ): deux
+//! \brief requêtes dont les points tombent dans les mêmes cellules d'une grille de p_tailleCellule km et dont les
+//! \brief heures de départ tombent dans la même tranche de p_dureeTranche secondes reçoivent la durée calculée pour
+//! \brief la première. La précision servie est donc celle de la grille et des tranches choisies.
+//! \brief Chaque entrée est associée à une version du réseau; le propriétaire du réseau appelle invalider() ou
+//! \brief changerFenetre() avec la nouvelle version au moment même où il remplace le réseau, et les résultats
+//! \brief calculés sur un réseau déjà remplacé ne sont jamais insérés.
+class CacheItineraires
+{
+public:
+
+    explicit CacheItineraires(size_t p_capacite, double p_tailleCellule = 0.2, unsigned int p_dureeTranche = 300);
+    CacheItineraires(const CacheItineraires &) = delete;
+    CacheItineraires &operator=(const CacheItineraires &) = delete;
+
+    bool chercher(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination, uint32_t p_heureDepart,
+                  uint64_t p_version, unsigned int &p_duree);
+    void inserer(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination, uint32_t p_heureDepart,
+                 uint64_t p_version, unsigned int p_duree);
+    void invalider(uint64_t p_version);
+    void changerFenetre(uint64_t p_version, uint32_t p_heureDepart);
+
+    StatistiquesCache getStatistiques() const;
+    size_t getCapacite() const;
+
+private:
+
+    struct Cle
+    {
+        int32_t ligneOrigine, colonneOrigine;
+        int32_t ligneDestination, colonneDestination;
+        uint32_t tranche;
+
+        bool operator==(const Cle &p_autre) const;
+    };
+
+    struct HachageCle
+    {
+        size_t operator()(const Cle &p_cle) const;
+    };
+
+    struct Entree
+    {
+        Cle cle;
+        unsigned int duree;
+    };
+
+    Cle construireCle(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                      uint32_t p_heureDepart) const;
+    void cellule(const Coordonnees &p_point, int32_t &p_ligne, int32_t &p_colonne) const;
+
+    const size_t m_capacite;
+    const double m_pasLat;             /*!< hauteur d'une cellule en degrés */
+    const double m_tailleCellule;      /*!< en km */
+    const unsigned int m_dureeTranche; /*!< en secondes */
+
+    mutable std::mutex m_verrou;       /*!< protège tous les membres suivants */
+    std::list<Entree> m_entrees;       /*!< de la plus récemment utilisée à la moins récemment utilisée */
+    std::unordered_map<Cle, std::list<Entree>::iterator, HachageCle> m_index;
+    uint64_t m_version;                /*!< version du réseau dont proviennent les entrées */
+    StatistiquesCache m_statistiques;
+};
+
+#endif //CACHEITINERAIRES_H
@@ -0,0 +1,172 @@
+//
+//  EmpreinteMemoire.cpp
+//  Bilan de la mémoire occupée par les structures chargées (octets, éléments et surcoût estimé de l'allocateur)
+//
+
+#include "empreinteMemoire.h"
+#include <iomanip>
+#include <tuple>
+
+#include "DonneesGTFS.h"
+#include "ReseauGTFS.h"
+#include "graphe.h"
+
+using namespace std;
+
+namespace
+{
+    //! \brief capacité d'un vecteur rempli par p_taille push_back (capacité doublée à chaque débordement)
+    size_t capaciteApresAjouts(size_t p_taille)
+    {
+        size_t capacite = p_taille ? 1 : 0;
+        while (capacite < p_taille) capacite *= 2;
+        return capacite;
+    }
+
+    double megaoctets(size_t p_octets)
+    {
+        return static_cast<double>(p_octets) / (1024.0 * 1024.0);
+    }
+
+    //! \brief p_texte complété par des espaces jusqu'à p_largeur caractères affichés (setw compte les octets UTF-8)
+    string colonne(const string &p_texte, size_t p_largeur, bool p_aGauche)
+    {
+        size_t largeur = 0;
+        for (char c : p_texte)
+        {
+            if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) ++largeur;
+        }
+        const string espaces(largeur < p_largeur ? p_largeur - largeur : 0, ' ');
+        return p_aGauche ? p_texte + espaces : espaces + p_texte;
+    }
+}
+
+//! \brief ajoute un poste vide nommé p_structure, à remplir par l'appelant
+PosteMemoire &RapportMemoire::ajouter(const string &p_structure)
+{
+    m_postes.emplace_back();
+    m_postes.back().structure = p_structure;
+    return m_postes.back();
+}
+
+//! \brief ajoute les conteneurs de DonneesGTFS, parcourus par son interface publique
+//! \brief Les chaînes internes aux objets Ligne, Station et Voyage ne sont comptées que si elles sont accessibles
+//! \brief par un accesseur (les clés des tables, le numéro de ligne, la ligne et la destination d'un voyage).
+void RapportMemoire::ajouterDonnees(const DonneesGTFS &p_gtfs)
+{
+    PosteMemoire &lignes = ajouter("DonneesGTFS::m_lignes");
+    lignes.elements = p_gtfs.getLignes().size();
+    compter(lignes, p_gtfs.getLignes());
+    for (const auto &ligne : p_gtfs.getLignes())
+    {
+        compter(lignes, ligne.first);
+        compter(lignes, ligne.second.getNumero());
+    }
+
+    PosteMemoire &stations = ajouter("DonneesGTFS::m_stations");
+    stations.elements = p_gtfs.getStations().size();
+    compter(stations, p_gtfs.getStations());
+    for (const auto &station : p_gtfs.getStations())
+    {
+        compter(stations, station.first);
+        compter(stations, station.second.getArrets());
+    }
+
+    PosteMemoire &voyages = ajouter("DonneesGTFS::m_voyages");
+    voyages.elements = p_gtfs.getVoyages().size();
+    compter(voyages, p_gtfs.getVoyages());
+    size_t nbArrets = 0;
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        compter(voyages, voyage.first);
+        compter(voyages, voyage.second.getLigne());
+        compter(voyages, voyage.second.getDestination());
+        compter(voyages, voyage.second.getArrets());
+        nbArrets += voyage.second.getArrets().size();
+    }
+
+    PosteMemoire &transferts = ajouter("DonneesGTFS::m_transferts");
+    transferts.elements = p_gtfs.getTransferts().size();
+    compter(transferts, p_gtfs.getTransferts());
+    for (const auto &transfert : p_gtfs.getTransferts())
+    {
+        compter(transferts, get<0>(transfert));
+        compter(transferts, get<1>(transfert));
+    }
+
+    PosteMemoire &stationsDeTransfert = ajouter("DonneesGTFS::m_stationsDeTransfert");
+    stationsDeTransfert.elements = p_gtfs.getStationsDeTransfert().size();
+    compter(stationsDeTransfert, p_gtfs.getStationsDeTransfert());
+    for (const auto &station : p_gtfs.getStationsDeTransfert()) compter(stationsDeTransfert, station);
+
+    //chaque arrêt appartient à un seul voyage et est partagé avec sa station
+    PosteMemoire &arrets = ajouter("Arret (std::make_shared)");
+    arrets.elements = nbArrets;
+    compterNoeuds(arrets, nbArrets, octetsBlocControle + sizeof(Arret));
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        for (const auto &arret : voyage.second.getArrets()) compter(arrets, arret->getStationId());
+    }
+}
+
+//! \brief ajoute une estimation des structures de ReseauGTFS, qui ne sont pas accessibles de l'extérieur
+//! \brief Un sommet par arrêt de p_gtfs; m_arretDuSommet est un vecteur rempli par push_back, m_sommetDeArret un
+//! \brief arbre indexé par Arret::Ptr et le graphe est figé à la fin de la construction (ajouterArcsAttente()).
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le réseau
+void RapportMemoire::ajouterReseauGTFS(const ReseauGTFS &p_reseau, const DonneesGTFS &p_gtfs)
+{
+    const size_t nbSommets = p_gtfs.getNbArrets();
+
+    PosteMemoire &arretDuSommet = ajouter("ReseauGTFS::m_arretDuSommet (estimé)");
+    arretDuSommet.elements = nbSommets;
+    compterBloc(arretDuSommet, capaciteApresAjouts(nbSommets) * sizeof(Arret::Ptr));
+
+    PosteMemoire &sommetDeArret = ajouter("ReseauGTFS::m_sommetDeArret (estimé)");
+    sommetDeArret.elements = nbSommets;
+    compterNoeuds(sommetDeArret, nbSommets, octetsEnteteNoeudArbre + sizeof(pair<const Arret::Ptr, size_t>));
+
+    PosteMemoire &graphe = ajouter("ReseauGTFS::m_leGraphe figé (estimé)");
+    Graphe::estimerMemoireFigee(nbSommets, p_reseau.getNbArcs(), graphe);
+}
+
+const vector<PosteMemoire> &RapportMemoire::getPostes() const
+{
+    return m_postes;
+}
+
+//! \return le total des octets et du surcoût de tous les postes
+size_t RapportMemoire::getTotal() const
+{
+    size_t total = 0;
+    for (const auto &poste : m_postes) total += poste.octets + poste.surcout;
+    return total;
+}
+
+//! \brief affiche un tableau des postes (éléments, octets, surcoût et total en Mo) suivi du total
+void RapportMemoire::afficher(ostream &p_flux) const
+{
+    const ios::fmtflags formatInitial = p_flux.flags();
+    const streamsize precisionInitiale = p_flux.precision();
+
+    p_flux << colonne("structure", 44, true) << colonne("éléments", 12, false) << colonne("octets", 14, false)
+           << colonne("surcoût", 14, false) << colonne("total (Mo)", 12, false) << endl;
+    for (const auto &poste : m_postes)
+    {
+        p_flux << colonne(poste.structure, 44, true) << right << setw(12) << poste.elements << setw(14)
+               << poste.octets << setw(14) << poste.surcout << setw(12) << fixed << setprecision(2)
+               << megaoctets(poste.octets + poste.surcout) << endl;
+    }
+    p_flux << colonne("total", 84, true) << right << setw(12) << fixed << setprecision(2)
+           << megaoctets(getTotal()) << endl;
+
+    p_flux.flags(formatInitial);
+    p_flux.precision(precisionInitiale);
+}
+
+//! \brief taille du bloc réellement réservé par glibc malloc pour une demande de p_octets
+//! \brief (en-tête de 8 octets, multiple de 16 octets, au moins 32 octets; pages de 4 Kio au-delà de 128 Kio)
+size_t RapportMemoire::tailleBloc(size_t p_octets)
+{
+    if (p_octets >= 128 * 1024) return (p_octets + 16 + 4095) / 4096 * 4096;
+    return max<size_t>(32, (p_octets + 8 + 15) / 16 * 16);
+}
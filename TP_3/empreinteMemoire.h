@@ -0,0 +1,107 @@
+//
+//  EmpreinteMemoire.h
+//  Bilan de la mémoire occupée par les structures chargées (octets, éléments et surcoût estimé de l'allocateur)
+//
+
+#ifndef EMPREINTEMEMOIRE_H
+#define EMPREINTEMEMOIRE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <set>
+#include <map>
+#include <iostream>
+#include <algorithm>
+
+class DonneesGTFS;
+class ReseauGTFS;
+
+//! \brief Mémoire occupée par une structure
+struct PosteMemoire
+{
+    std::string structure;
+    size_t elements = 0;
+    size_t octets = 0;   /*!< octets des objets et des blocs alloués, tels que demandés à l'allocateur */
+    size_t surcout = 0;  /*!< estimation des en-têtes et de l'arrondi de l'allocateur pour ces blocs */
+};
+
+//! \brief Bilan de la mémoire occupée par une suite de structures
+//! \brief Les tailles des noeuds des conteneurs et le surcoût de l'allocateur sont estimés pour libstdc++ et
+//! \brief glibc malloc (en-tête de 8 octets, blocs multiples de 16 octets d'au moins 32 octets) sur 64 bits.
+class RapportMemoire
+{
+public:
+
+    PosteMemoire &ajouter(const std::string &p_structure);
+    void ajouterDonnees(const DonneesGTFS &p_gtfs);
+    void ajouterReseauGTFS(const ReseauGTFS &p_reseau, const DonneesGTFS &p_gtfs);
+    const std::vector<PosteMemoire> &getPostes() const;
+    size_t getTotal() const;
+    void afficher(std::ostream &p_flux) const;
+
+    static size_t tailleBloc(size_t p_octets);
+
+    //! \brief un bloc de p_octets obtenu de l'allocateur
+    static void compterBloc(PosteMemoire &p_poste, size_t p_octets)
+    {
+        if (p_octets == 0) return;
+        p_poste.octets += p_octets;
+        p_poste.surcout += tailleBloc(p_octets) - p_octets;
+    }
+
+    //! \brief p_nombre noeuds d'un conteneur, chacun alloué séparément
+    static void compterNoeuds(PosteMemoire &p_poste, size_t p_nombre, size_t p_octetsParNoeud)
+    {
+        p_poste.octets += p_nombre * p_octetsParNoeud;
+        p_poste.surcout += p_nombre * (tailleBloc(p_octetsParNoeud) - p_octetsParNoeud);
+    }
+
+    //! \brief partie allouée d'une chaîne (les chaînes courtes sont logées dans l'objet lui-même)
+    static void compter(PosteMemoire &p_poste, const std::string &p_chaine)
+    {
+        if (p_chaine.capacity() > capaciteChaineCourte) compterBloc(p_poste, p_chaine.capacity() + 1);
+    }
+
+    template<typename T, typename A>
+    static void compter(PosteMemoire &p_poste, const std::vector<T, A> &p_vecteur)
+    {
+        compterBloc(p_poste, p_vecteur.capacity() * sizeof(T));
+    }
+
+    template<typename T, typename A>
+    static void compter(PosteMemoire &p_poste, const std::list<T, A> &p_liste)
+    {
+        compterNoeuds(p_poste, p_liste.size(), octetsEnteteNoeudListe + sizeof(T));
+    }
+
+    template<typename K, typename C, typename A>
+    static void compter(PosteMemoire &p_poste, const std::set<K, C, A> &p_ensemble)
+    {
+        compterNoeuds(p_poste, p_ensemble.size(), octetsEnteteNoeudArbre + sizeof(K));
+    }
+
+    template<typename K, typename V, typename C, typename A>
+    static void compter(PosteMemoire &p_poste, const std::map<K, V, C, A> &p_table)
+    {
+        compterNoeuds(p_poste, p_table.size(), octetsEnteteNoeudArbre + sizeof(typename std::map<K, V, C, A>::value_type));
+    }
+
+    template<typename K, typename V, typename C, typename A>
+    static void compter(PosteMemoire &p_poste, const std::multimap<K, V, C, A> &p_table)
+    {
+        compterNoeuds(p_poste, p_table.size(),
+                      octetsEnteteNoeudArbre + sizeof(typename std::multimap<K, V, C, A>::value_type));
+    }
+
+    static constexpr size_t capaciteChaineCourte = 15;     /*!< std::string sans allocation (libstdc++) */
+    static constexpr size_t octetsEnteteNoeudListe = 16;   /*!< deux pointeurs */
+    static constexpr size_t octetsEnteteNoeudArbre = 32;   /*!< couleur et trois pointeurs (arbre rouge-noir) */
+    static constexpr size_t octetsBlocControle = 16;       /*!< compteurs d'un std::make_shared, logés avec l'objet */
+
+private:
+
+    std::vector<PosteMemoire> m_postes;
+};
+
+#endif //EMPREINTEMEMOIRE_H
@@ -0,0 +1,335 @@
+//
+//  GenerateurGTFS.cpp
+//  Génère un jeu de données GTFS synthétique, reproductible, pour mesurer le chargement et les requêtes à grande échelle
+//
+//  Programme autonome: compiler generateurGTFS.cpp seul.
+//  usage: generateurGTFS <dossier> [cle=valeur ...]
+//  clés: stations, lignes, arretsParLigne, premierDepart, dernierDepart (HH:MM), intervalle (secondes entre deux
+//        départs d'une ligne), transferts (proportion des stations ayant des transferts), arretsLongs (proportion
+//        des arrêts où l'autobus attend jusqu'à deux intervalles: un voyage suivant de la même ligne peut alors
+//        arriver après lui et repartir avant lui), date (AAAAMMJJ), graine
+//  Les colonnes écrites sont celles lues par DonneesGTFS (TP_1).
+//
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace
+{
+    //! \brief paramètres du réseau généré
+    struct Parametres
+    {
+        unsigned int stations = 4000;
+        unsigned int lignes = 150;
+        unsigned int arretsParLigne = 30;
+        unsigned int premierDepart = 5 * 3600;
+        unsigned int dernierDepart = 24 * 3600;
+        unsigned int intervalle = 900;
+        double transferts = 0.1;
+        double arretsLongs = 0.0;
+        string date = "20220803";
+        uint32_t graine = 1;
+    };
+
+    const double latitudeCentre = 46.8;
+    const double longitudeCentre = -71.3;
+    const double kmParDegreLatitude = 111.2;
+    const double kmParDegreLongitude = 76.1;   /*!< à la latitude de Québec */
+    const double stationsParKm2 = 8.0;         /*!< densité constante: la surface croît avec le nombre de stations */
+    const double distanceEntreArrets = 0.45;   /*!< en km */
+    const double vitesseBus = 25.0;            /*!< en km/h */
+    const unsigned int arretEnStation = 20;    /*!< en secondes */
+    const double rayonTransfert = 0.3;         /*!< en km */
+
+    //! \brief générateur pseudo-aléatoire dont les tirages ne dépendent que de la graine (et non de la bibliothèque)
+    class Hasard
+    {
+    public:
+        explicit Hasard(uint32_t p_graine) : m_etat(p_graine * 2654435761ULL + 1)
+        {
+        }
+        uint32_t suivant()
+        {
+            //xorshift64*
+            m_etat ^= m_etat >> 12;
+            m_etat ^= m_etat << 25;
+            m_etat ^= m_etat >> 27;
+            return static_cast<uint32_t>((m_etat * 2685821657736338717ULL) >> 32);
+        }
+        uint32_t entier(uint32_t p_borne)
+        {
+            return p_borne ? static_cast<uint32_t>((static_cast<uint64_t>(suivant()) * p_borne) >> 32) : 0;
+        }
+        double reel()
+        {
+            return suivant() / 4294967296.0;
+        }
+    private:
+        uint64_t m_etat;
+    };
+
+    //! \brief position d'une station en km par rapport au coin de la région
+    struct Position
+    {
+        double x;
+        double y;
+    };
+
+    double distance(const Position &a, const Position &b)
+    {
+        return hypot(a.x - b.x, a.y - b.y);
+    }
+
+    //! \brief grille de cases de 1 km pour trouver les stations proches d'un point
+    class Grille
+    {
+    public:
+        Grille(const vector<Position> &p_positions, double p_cote)
+                : m_positions(p_positions), m_nbCases(max(1, static_cast<int>(ceil(p_cote)))),
+                  m_cases(static_cast<size_t>(m_nbCases) * static_cast<size_t>(m_nbCases))
+        {
+            for (uint32_t s = 0; s < p_positions.size(); ++s) m_cases[indice(caseDe(p_positions[s].x), caseDe(p_positions[s].y))].push_back(s);
+        }
+
+        //! \brief applique p_fonction(station) aux stations des cases à moins de p_rayon cases de p_point
+        template<typename Fonction>
+        void parcourir(const Position &p_point, int p_rayon, Fonction p_fonction) const
+        {
+            const int cx = caseDe(p_point.x), cy = caseDe(p_point.y);
+            for (int x = max(0, cx - p_rayon); x <= min(m_nbCases - 1, cx + p_rayon); ++x)
+                for (int y = max(0, cy - p_rayon); y <= min(m_nbCases - 1, cy + p_rayon); ++y)
+                    for (uint32_t s : m_cases[indice(x, y)]) p_fonction(s);
+        }
+
+    private:
+        int caseDe(double p_km) const
+        {
+            return min(m_nbCases - 1, max(0, static_cast<int>(p_km)));
+        }
+        size_t indice(int x, int y) const
+        {
+            return static_cast<size_t>(x) * static_cast<size_t>(m_nbCases) + static_cast<size_t>(y);
+        }
+
+        const vector<Position> &m_positions;
+        int m_nbCases;
+        vector<vector<uint32_t> > m_cases;
+    };
+
+    string heure(unsigned int p_secondes)
+    {
+        char tampon[16];
+        snprintf(tampon, sizeof(tampon), "%02u:%02u:%02u", p_secondes / 3600, p_secondes / 60 % 60, p_secondes % 60);
+        return tampon;
+    }
+
+    unsigned int lireHeure(const string &p_texte)
+    {
+        const size_t separateur = p_texte.find(':');
+        if (separateur == string::npos) throw logic_error("heure invalide (HH:MM attendu): " + p_texte);
+        return static_cast<unsigned int>(stoul(p_texte.substr(0, separateur)) * 3600 +
+                                         stoul(p_texte.substr(separateur + 1)) * 60);
+    }
+
+    //! \throws logic_error si une clé est inconnue ou une valeur invalide
+    Parametres lireParametres(int argc, char *argv[])
+    {
+        Parametres parametres;
+        for (int i = 2; i < argc; ++i)
+        {
+            const string argument(argv[i]);
+            const size_t egal = argument.find('=');
+            if (egal == string::npos) throw logic_error("argument invalide (cle=valeur attendu): " + argument);
+            const string cle = argument.substr(0, egal), valeur = argument.substr(egal + 1);
+            if (cle == "stations") parametres.stations = static_cast<unsigned int>(stoul(valeur));
+            else if (cle == "lignes") parametres.lignes = static_cast<unsigned int>(stoul(valeur));
+            else if (cle == "arretsParLigne") parametres.arretsParLigne = static_cast<unsigned int>(stoul(valeur));
+            else if (cle == "premierDepart") parametres.premierDepart = lireHeure(valeur);
+            else if (cle == "dernierDepart") parametres.dernierDepart = lireHeure(valeur);
+            else if (cle == "intervalle") parametres.intervalle = static_cast<unsigned int>(stoul(valeur));
+            else if (cle == "transferts") parametres.transferts = stod(valeur);
+            else if (cle == "arretsLongs") parametres.arretsLongs = stod(valeur);
+            else if (cle == "date") parametres.date = valeur;
+            else if (cle == "graine") parametres.graine = static_cast<uint32_t>(stoul(valeur));
+            else throw logic_error("clé inconnue: " + cle);
+        }
+        if (parametres.stations < 2 || parametres.arretsParLigne < 2 || parametres.intervalle == 0 ||
+            parametres.date.size() != 8 || parametres.dernierDepart < parametres.premierDepart)
+            throw logic_error("paramètres invalides");
+        return parametres;
+    }
+
+    ofstream ouvrir(const string &p_dossier, const string &p_fichier, const string &p_entete)
+    {
+        ofstream flux(p_dossier + "/" + p_fichier);
+        if (!flux) throw logic_error("impossible d'écrire " + p_dossier + "/" + p_fichier);
+        flux << p_entete << '\n';
+        return flux;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cerr << "usage: " << argv[0] << " <dossier> [cle=valeur ...]" << endl;
+        return 1;
+    }
+    try
+    {
+        const string dossier(argv[1]);
+        const Parametres parametres = lireParametres(argc, argv);
+        mkdir(dossier.c_str(), 0755);
+        Hasard hasard(parametres.graine);
+
+        //stations réparties uniformément dans un carré
+        const double cote = sqrt(parametres.stations / stationsParKm2);
+        vector<Position> positions(parametres.stations);
+        for (auto &position : positions) position = {hasard.reel() * cote, hasard.reel() * cote};
+        const Grille grille(positions, cote);
+        {
+            ofstream stops = ouvrir(dossier, "stops.txt", "stop_id,stop_code,stop_name,stop_desc,stop_lat,stop_lon");
+            stops.precision(7);
+            for (uint32_t s = 0; s < parametres.stations; ++s)
+            {
+                stops << 'S' << s << ',' << s << ",Station " << s << ",Arrêt " << s << ','
+                      << fixed << latitudeCentre + (positions[s].y - cote / 2) / kmParDegreLatitude << ','
+                      << longitudeCentre + (positions[s].x - cote / 2) / kmParDegreLongitude << '\n';
+            }
+        }
+
+        //chaque ligne suit un cap qui dévie peu à peu et dessert la station libre la plus proche de chaque point
+        vector<vector<uint32_t> > parcours(parametres.lignes);
+        for (auto &arrets : parcours)
+        {
+            Position point = positions[hasard.entier(parametres.stations)];
+            double cap = hasard.reel() * 2 * M_PI;
+            for (unsigned int a = 0; a < parametres.arretsParLigne; ++a)
+            {
+                uint32_t meilleure = parametres.stations;
+                double meilleureDistance = 0;
+                for (int rayon = 1; meilleure == parametres.stations && rayon <= cote + 1; rayon *= 2)
+                {
+                    grille.parcourir(point, rayon, [&](uint32_t s)
+                    {
+                        if (find(arrets.begin(), arrets.end(), s) != arrets.end()) return;
+                        const double d = distance(point, positions[s]);
+                        if (meilleure == parametres.stations || d < meilleureDistance)
+                        {
+                            meilleure = s;
+                            meilleureDistance = d;
+                        }
+                    });
+                }
+                if (meilleure == parametres.stations) break;
+                arrets.push_back(meilleure);
+                cap += (hasard.reel() - 0.5) * 0.6;
+                point = {positions[meilleure].x + cos(cap) * distanceEntreArrets,
+                         positions[meilleure].y + sin(cap) * distanceEntreArrets};
+                //on rebrousse chemin au bord de la région
+                if (point.x < 0 || point.y < 0 || point.x > cote || point.y > cote)
+                {
+                    cap += M_PI;
+                    point = {min(max(point.x, 0.0), cote), min(max(point.y, 0.0), cote)};
+                }
+            }
+        }
+
+        {
+            ofstream routes = ouvrir(dossier, "routes.txt",
+                                     "route_id,agency_id,route_short_name,route_long_name,route_desc,route_type,route_url,route_color");
+            for (uint32_t l = 0; l < parametres.lignes; ++l)
+            {
+                routes << 'L' << l << ",SYN," << l + 1 << ",Ligne " << l + 1 << ",Ligne synthétique " << l + 1
+                       << ",3,," << (l % 5 == 0 ? "97BF0D" : "013888") << '\n';
+            }
+        }
+        {
+            //SEM est en service à la date; un voyage sur dix relève de FER, retiré à cette date
+            ofstream calendrier = ouvrir(dossier, "calendar_dates.txt", "service_id,date,exception_type");
+            calendrier << "SEM," << parametres.date << ",1\n";
+            calendrier << "FER," << parametres.date << ",2\n";
+        }
+
+        size_t nbVoyages = 0, nbArrets = 0;
+        {
+            ofstream trips = ouvrir(dossier, "trips.txt", "route_id,service_id,trip_short_name,trip_id,trip_headsign");
+            ofstream stopTimes = ouvrir(dossier, "stop_times.txt",
+                                        "trip_id,arrival_time,departure_time,stop_id,stop_sequence");
+            for (uint32_t l = 0; l < parametres.lignes; ++l)
+            {
+                const vector<uint32_t> &aller = parcours[l];
+                if (aller.size() < 2) continue;
+                const unsigned int decalage = hasard.entier(parametres.intervalle);
+                for (unsigned int sens = 0; sens < 2; ++sens)
+                {
+                    vector<uint32_t> arrets(aller);
+                    if (sens == 1) reverse(arrets.begin(), arrets.end());
+                    for (unsigned int depart = parametres.premierDepart + decalage; depart <= parametres.dernierDepart;
+                         depart += parametres.intervalle)
+                    {
+                        const size_t v = nbVoyages++;
+                        trips << 'L' << l << ',' << (v % 10 == 9 ? "FER" : "SEM") << ',' << v << ",V" << v
+                              << ",Station " << arrets.back() << '\n';
+                        unsigned int instant = depart;
+                        for (size_t a = 0; a < arrets.size(); ++a)
+                        {
+                            if (a > 0)
+                            {
+                                const double km = distance(positions[arrets[a - 1]], positions[arrets[a]]);
+                                instant += static_cast<unsigned int>(km / vitesseBus * 3600) + hasard.entier(30);
+                            }
+                            //aucun tirage sans arrêts longs: les jeux de données déjà générés restent identiques
+                            unsigned int arret = arretEnStation;
+                            if (parametres.arretsLongs > 0 && hasard.reel() < parametres.arretsLongs)
+                                arret += hasard.entier(2 * parametres.intervalle);
+                            stopTimes << 'V' << v << ',' << heure(instant) << ',' << heure(instant + arret)
+                                      << ",S" << arrets[a] << ',' << a + 1 << '\n';
+                            instant += arret;
+                            ++nbArrets;
+                        }
+                    }
+                }
+            }
+        }
+
+        size_t nbTransferts = 0;
+        {
+            ofstream transfers = ouvrir(dossier, "transfers.txt",
+                                        "from_stop_id,to_stop_id,transfer_type,min_transfer_time");
+            for (uint32_t s = 0; s < parametres.stations; ++s)
+            {
+                if (hasard.reel() >= parametres.transferts) continue;
+                transfers << 'S' << s << ",S" << s << ",2,60\n";
+                ++nbTransferts;
+                grille.parcourir(positions[s], 1, [&](uint32_t t)
+                {
+                    const double km = distance(positions[s], positions[t]);
+                    if (t == s || km > rayonTransfert) return;
+                    transfers << 'S' << s << ",S" << t << ",2," << max(60u, static_cast<unsigned int>(km / 5.0 * 3600))
+                              << '\n';
+                    ++nbTransferts;
+                });
+            }
+        }
+
+        cerr << "Stations: " << parametres.stations << ", lignes: " << parametres.lignes << ", voyages: " << nbVoyages
+             << ", arrêts: " << nbArrets << ", transferts: " << nbTransferts << endl;
+    }
+    catch (const exception &e)
+    {
+        cerr << "Erreur: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -6,15 +6,102 @@
 //
 
 #include "graphe.h"
+#include "empreinteMemoire.h"
+#include <cstring>
+#include <chrono>
 
 using namespace std;
 
+//mise à jour des StatistiquesRecherche, retirée à la compilation sans -DSTATISTIQUES_RECHERCHE
+#ifdef STATISTIQUES_RECHERCHE
+#define COMPTER(instruction) instruction
+
+namespace
+{
+    long microsecondesDepuis(chrono::steady_clock::time_point p_debut)
+    {
+        return static_cast<long>(
+                chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - p_debut).count());
+    }
+}
+#else
+#define COMPTER(instruction)
+#endif
+
 //! \brief Constructeur avec paramètre du nombre de sommets désiré
 //! \param[in] p_nbSommets indique le nombre de sommets désiré
 //! \post crée le vecteur de p_nbSommets de listes d'adjacence vides avec nbArcs=0
 Graphe::Graphe(size_t p_nbSommets)
-        : m_listesAdj(p_nbSommets), m_nbArcs(0)
+        : m_listesAdj(p_nbSommets), m_nbArcs(0), m_nbSommetsFiges(0), m_projete(false)
+{
+}
+
+//! \brief une représentation figée projetée (projeter()) n'est pas copiée: la copie lit la même zone
+Graphe::Graphe(const Graphe &p_graphe)
+        : m_listesAdj(p_graphe.m_listesAdj), m_nbArcs(p_graphe.m_nbArcs), m_fige(p_graphe.m_fige),
+          m_debutArcs(p_graphe.m_debutArcs), m_destinations(p_graphe.m_destinations),
+          m_poidsFiges(p_graphe.m_poidsFiges), m_nbSommetsFiges(p_graphe.m_nbSommetsFiges),
+          m_projete(p_graphe.m_projete)
+{
+    lierTableaux();
+}
+
+Graphe::Graphe(Graphe &&p_graphe) noexcept
+        : m_listesAdj(std::move(p_graphe.m_listesAdj)), m_nbArcs(p_graphe.m_nbArcs), m_fige(p_graphe.m_fige),
+          m_debutArcs(std::move(p_graphe.m_debutArcs)), m_destinations(std::move(p_graphe.m_destinations)),
+          m_poidsFiges(std::move(p_graphe.m_poidsFiges)), m_nbSommetsFiges(p_graphe.m_nbSommetsFiges),
+          m_projete(p_graphe.m_projete)
+{
+    lierTableaux();
+    p_graphe.m_fige = TableauxFiges();
+    p_graphe.m_nbSommetsFiges = 0;
+    p_graphe.m_nbArcs = 0;
+}
+
+Graphe &Graphe::operator=(const Graphe &p_graphe)
+{
+    if (this != &p_graphe) *this = Graphe(p_graphe);
+    return *this;
+}
+
+Graphe &Graphe::operator=(Graphe &&p_graphe) noexcept
+{
+    if (this == &p_graphe) return *this;
+    m_listesAdj = std::move(p_graphe.m_listesAdj);
+    m_nbArcs = p_graphe.m_nbArcs;
+    m_fige = p_graphe.m_fige;
+    m_debutArcs = std::move(p_graphe.m_debutArcs);
+    m_destinations = std::move(p_graphe.m_destinations);
+    m_poidsFiges = std::move(p_graphe.m_poidsFiges);
+    m_nbSommetsFiges = p_graphe.m_nbSommetsFiges;
+    m_projete = p_graphe.m_projete;
+    lierTableaux();
+    p_graphe.m_fige = TableauxFiges();
+    p_graphe.m_nbSommetsFiges = 0;
+    p_graphe.m_nbArcs = 0;
+    return *this;
+}
+
+//! \brief fait lire la représentation figée dans les vecteurs du graphe, sauf si elle est projetée
+void Graphe::lierTableaux()
 {
+    if (!m_projete) m_fige = {m_debutArcs.data(), m_destinations.data(), m_poidsFiges.data()};
+}
+
+//! \brief copie une représentation projetée dans les vecteurs du graphe, afin de pouvoir la modifier
+void Graphe::materialiser()
+{
+    if (!m_projete) return;
+    m_debutArcs.assign(m_fige.debutArcs, m_fige.debutArcs + m_nbSommetsFiges + 1);
+    m_destinations.assign(m_fige.destinations, m_fige.destinations + getNbArcsFiges());
+    m_poidsFiges.assign(m_fige.poids, m_fige.poids + getNbArcsFiges());
+    m_projete = false;
+    lierTableaux();
+}
+
+size_t Graphe::getNbArcsFiges() const
+{
+    return m_nbSommetsFiges > 0 ? m_fige.debutArcs[m_nbSommetsFiges] : 0;
 }
 
 //! \brief change le nombre de sommets du graphe
@@ -23,8 +110,11 @@ Graphe::Graphe(size_t p_nbSommets)
 //! \post les anciennes listes d'adjacence sont toujours présentes lorsque p_nouvelleTaille >= à l'ancienne taille
 //! \post les dernières listes d'adjacence sont enlevées lorsque p_nouvelleTaille < à l'ancienne taille
 //! \post nbArcs est diminué par le nombre d'arcs sortant des sommets à enlever si certaines listes d'adgacence sont supprimées
+//! \throws logic_error lorsque p_nouvelleTaille enlèverait des sommets figés
 void Graphe::resize(size_t p_nouvelleTaille)
 {
+    if (p_nouvelleTaille < m_nbSommetsFiges)
+        throw logic_error("Graphe::resize(): impossible d'enlever des sommets figés");
     if (p_nouvelleTaille < m_listesAdj.size()) //certaines listes d'adj seront supprimées
     {
         //diminuer nbArcs par le nb d'arcs sortant des sommets à enlever
@@ -46,6 +136,259 @@ size_t Graphe::getNbArcs() const
     return m_nbArcs;
 }
 
+//! \brief fige les arcs présents dans une représentation compacte (compressed sparse row)
+//! \brief les destinations et les poids sont stockés sur 32 bits dans deux tableaux contigus
+//! \post les listes d'adjacence sont vidées; elles ne contiennent plus que les arcs ajoutés après figer()
+//! \post les arcs figés ne peuvent plus être enlevés et les sommets figés ne peuvent plus être supprimés
+//! \throws logic_error lorsque le nombre de sommets ou d'arcs ne peut être représenté sur 32 bits
+void Graphe::figer()
+{
+    figer(vector<TamponArcs>());
+}
+
+//! \brief fige les arcs présents ainsi que ceux des tampons, en un seul passage de tri par dénombrement
+//! \brief les arcs d'un sommet sont rangés dans l'ordre: arcs déjà figés, listes d'adjacence, puis tampons dans
+//! \brief l'ordre de p_tampons et de leurs ajouts, soit l'ordre qu'auraient donné des appels successifs à ajouterArc()
+//! \param[in] p_tampons: les arcs collectés hors du graphe, p. ex. par plusieurs fils d'exécution
+//! \post les listes d'adjacence sont vidées; elles ne contiennent plus que les arcs ajoutés après figer()
+//! \throws logic_error lorsqu'un arc d'un tampon a un sommet inexistant ou un poids interdit
+//! \throws logic_error lorsque le nombre de sommets ou d'arcs ne peut être représenté sur 32 bits
+void Graphe::figer(const vector<TamponArcs> &p_tampons)
+{
+    const size_t nbSommets = m_listesAdj.size();
+    size_t nbArcs = m_nbArcs;
+    for (const auto &tampon : p_tampons) nbArcs += tampon.size();
+    if (nbSommets >= numeric_limits<uint32_t>::max() || nbArcs >= numeric_limits<uint32_t>::max())
+        throw logic_error("Graphe::figer(): le graphe est trop grand pour être figé");
+
+    vector<uint32_t> debutArcs(nbSommets + 1, 0);
+    for (const auto &tampon : p_tampons)
+    {
+        for (size_t k = 0; k < tampon.size(); ++k)
+        {
+            if (tampon.origines[k] >= nbSommets || tampon.destinations[k] >= nbSommets)
+                throw logic_error("Graphe::figer(): un arc d'un tampon a un sommet inexistant");
+            if (tampon.poids[k] == numeric_limits<unsigned int>::max())
+                throw logic_error("Graphe::figer(): valeur de poids interdite dans un tampon");
+            ++debutArcs[tampon.origines[k] + 1];
+        }
+    }
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        size_t nbArcsFiges = i < m_nbSommetsFiges ? m_fige.debutArcs[i + 1] - m_fige.debutArcs[i] : 0;
+        debutArcs[i + 1] += static_cast<uint32_t>(debutArcs[i] + nbArcsFiges + m_listesAdj[i].size());
+    }
+
+    vector<uint32_t> destinations(nbArcs);
+    vector<uint32_t> poids(nbArcs);
+    vector<uint32_t> prochain(debutArcs.begin(), debutArcs.end() - 1); //prochaine position libre de chaque sommet
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        uint32_t &k = prochain[i];
+        parcourirArcs(i, [&](size_t j, unsigned int p)
+        {
+            destinations[k] = static_cast<uint32_t>(j);
+            poids[k] = p;
+            ++k;
+        });
+    }
+    for (const auto &tampon : p_tampons)
+    {
+        for (size_t k = 0; k < tampon.size(); ++k)
+        {
+            const uint32_t position = prochain[tampon.origines[k]]++;
+            destinations[position] = tampon.destinations[k];
+            poids[position] = tampon.poids[k];
+        }
+    }
+
+    m_debutArcs.swap(debutArcs);
+    m_destinations.swap(destinations);
+    m_poidsFiges.swap(poids);
+    m_projete = false;
+    lierTableaux();
+    m_nbSommetsFiges = nbSommets;
+    m_nbArcs = nbArcs;
+    vector<list<Arc> >(nbSommets).swap(m_listesAdj); //libère les noeuds des listes
+}
+
+//! \brief copie figée de p_graphe dont tous les arcs sortant des sommets marqués sont remplacés par ceux de p_arcs,
+//! \brief en un seul passage: p_graphe n'est lu qu'une fois, sans être d'abord copié
+//! \brief les arcs des autres sommets sont conservés dans leur ordre; ceux de p_arcs gardent l'ordre de leurs ajouts
+//! \param[in] p_sommetsRemplaces: p_sommetsRemplaces[i] != 0 si les arcs sortant de i sont remplacés
+//! \param[in] p_arcs: les nouveaux arcs, qui doivent tous sortir de sommets marqués
+//! \throws logic_error si p_graphe n'est pas entièrement figé ou si un arc de p_arcs est invalide
+Graphe::Graphe(const Graphe &p_graphe, const vector<uint8_t> &p_sommetsRemplaces, const TamponArcs &p_arcs)
+        : m_listesAdj(p_graphe.m_listesAdj.size()), m_nbArcs(0), m_nbSommetsFiges(p_graphe.m_listesAdj.size()),
+          m_projete(false)
+{
+    const size_t nbSommets = m_listesAdj.size();
+    const TableauxFiges &source = p_graphe.m_fige;
+    if (p_graphe.m_nbSommetsFiges != nbSommets || p_graphe.getNbArcsFiges() != p_graphe.m_nbArcs ||
+        p_sommetsRemplaces.size() != nbSommets)
+        throw logic_error("Graphe::remplacerArcs(): le graphe doit être entièrement figé");
+
+    vector<uint32_t> debutArcs(nbSommets + 1, 0);
+    for (size_t k = 0; k < p_arcs.size(); ++k)
+    {
+        if (p_arcs.origines[k] >= nbSommets || p_arcs.destinations[k] >= nbSommets ||
+            !p_sommetsRemplaces[p_arcs.origines[k]])
+            throw logic_error("Graphe::remplacerArcs(): un arc ne sort pas d'un sommet remplacé");
+        if (p_arcs.poids[k] == numeric_limits<unsigned int>::max())
+            throw logic_error("Graphe::remplacerArcs(): valeur de poids interdite");
+        ++debutArcs[p_arcs.origines[k] + 1];
+    }
+    size_t nbArcs = 0;
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        if (!p_sommetsRemplaces[i]) debutArcs[i + 1] = source.debutArcs[i + 1] - source.debutArcs[i];
+        nbArcs += debutArcs[i + 1];
+        if (nbArcs >= numeric_limits<uint32_t>::max())
+            throw logic_error("Graphe::remplacerArcs(): le graphe est trop grand pour être figé");
+        debutArcs[i + 1] = static_cast<uint32_t>(nbArcs);
+    }
+
+    vector<uint32_t> destinations(nbArcs);
+    vector<uint32_t> poids(nbArcs);
+    for (size_t i = 0; i < nbSommets; ++i)
+    {
+        if (p_sommetsRemplaces[i]) continue;
+        copy(source.destinations + source.debutArcs[i], source.destinations + source.debutArcs[i + 1],
+             destinations.begin() + debutArcs[i]);
+        copy(source.poids + source.debutArcs[i], source.poids + source.debutArcs[i + 1],
+             poids.begin() + debutArcs[i]);
+    }
+    vector<uint32_t> prochain(debutArcs.begin(), debutArcs.end() - 1);
+    for (size_t k = 0; k < p_arcs.size(); ++k)
+    {
+        const uint32_t position = prochain[p_arcs.origines[k]]++;
+        destinations[position] = p_arcs.destinations[k];
+        poids[position] = p_arcs.poids[k];
+    }
+
+    m_debutArcs.swap(debutArcs);
+    m_destinations.swap(destinations);
+    m_poidsFiges.swap(poids);
+    lierTableaux();
+    m_nbArcs = nbArcs;
+}
+
+//! \brief remplace tous les arcs sortant des sommets marqués par les arcs de p_arcs (voir le constructeur
+//! \brief Graphe(const Graphe &, const std::vector<uint8_t> &, const TamponArcs &))
+//! \throws logic_error si le graphe n'est pas entièrement figé ou si un arc de p_arcs est invalide
+void Graphe::remplacerArcs(const vector<uint8_t> &p_sommetsRemplaces, const TamponArcs &p_arcs)
+{
+    *this = Graphe(*this, p_sommetsRemplaces, p_arcs);
+}
+
+//! \brief change le poids de l'arc figé (i, j) (du premier s'il y en a plusieurs)
+//! \brief une représentation projetée est d'abord copiée dans le graphe
+//! \throws logic_error si l'arc n'est pas dans la représentation figée ou si le poids est interdit
+void Graphe::modifierPoids(size_t i, size_t j, unsigned int p_poids)
+{
+    if (p_poids == numeric_limits<unsigned int>::max())
+        throw logic_error("Graphe::modifierPoids(): valeur de poids interdite");
+    materialiser();
+    if (i < m_nbSommetsFiges)
+    {
+        for (uint32_t k = m_debutArcs[i]; k < m_debutArcs[i + 1]; ++k)
+        {
+            if (m_destinations[k] == j)
+            {
+                m_poidsFiges[k] = p_poids;
+                return;
+            }
+        }
+    }
+    throw logic_error("Graphe::modifierPoids(): l'arc n'est pas figé");
+}
+
+bool Graphe::estFige() const
+{
+    return m_nbSommetsFiges > 0;
+}
+
+//! \brief écrit la représentation figée en binaire (ordre des octets de la machine)
+//! \brief format: nbSommets et nbArcs sur 64 bits, puis m_debutArcs, m_destinations et m_poidsFiges sur 32 bits
+//! \throws logic_error lorsque des arcs ont été ajoutés depuis le dernier appel à figer()
+void Graphe::sauvegarder(ostream &p_flux) const
+{
+    if (m_nbSommetsFiges != m_listesAdj.size() || getNbArcsFiges() != m_nbArcs)
+        throw logic_error("Graphe::sauvegarder(): le graphe doit être entièrement figé");
+    const uint64_t tailles[2] = {m_nbSommetsFiges, m_nbArcs};
+    p_flux.write(reinterpret_cast<const char *>(tailles), sizeof(tailles));
+    p_flux.write(reinterpret_cast<const char *>(m_fige.debutArcs), (m_nbSommetsFiges + 1) * sizeof(uint32_t));
+    p_flux.write(reinterpret_cast<const char *>(m_fige.destinations), m_nbArcs * sizeof(uint32_t));
+    p_flux.write(reinterpret_cast<const char *>(m_fige.poids), m_nbArcs * sizeof(uint32_t));
+}
+
+//! \brief vérifie une représentation figée écrite par sauvegarder()
+//! \return le nombre d'octets de la représentation
+//! \throws logic_error lorsque les données sont tronquées ou incohérentes
+size_t Graphe::verifierRepresentation(const char *p_donnees, size_t p_taille) const
+{
+    uint64_t tailles[2];
+    if (p_taille < sizeof(tailles))
+        throw logic_error("Graphe::charger(): données tronquées");
+    memcpy(tailles, p_donnees, sizeof(tailles));
+    const uint64_t nbSommets = tailles[0], nbArcs = tailles[1];
+    if (nbSommets >= numeric_limits<uint32_t>::max() || nbArcs >= numeric_limits<uint32_t>::max() ||
+        p_taille < sizeof(tailles) + (nbSommets + 1 + 2 * nbArcs) * sizeof(uint32_t))
+        throw logic_error("Graphe::charger(): données tronquées");
+
+    const uint32_t *debutArcs = reinterpret_cast<const uint32_t *>(p_donnees + sizeof(tailles));
+    const uint32_t *destinations = debutArcs + nbSommets + 1;
+    if (debutArcs[0] != 0 || debutArcs[nbSommets] != nbArcs || !is_sorted(debutArcs, debutArcs + nbSommets + 1) ||
+        any_of(destinations, destinations + nbArcs, [&](uint32_t j) { return j >= nbSommets; }))
+        throw logic_error("Graphe::charger(): données incohérentes");
+    return sizeof(tailles) + (nbSommets + 1 + 2 * nbArcs) * sizeof(uint32_t);
+}
+
+//! \brief remplace le graphe par une copie d'une représentation figée écrite par sauvegarder()
+//! \param[in] p_donnees: le début de la représentation (p. ex. dans un fichier projeté en mémoire)
+//! \param[in] p_taille: le nombre d'octets disponibles à partir de p_donnees
+//! \return le nombre d'octets lus
+//! \throws logic_error lorsque les données sont tronquées ou incohérentes
+size_t Graphe::charger(const char *p_donnees, size_t p_taille)
+{
+    const size_t taille = projeter(p_donnees, p_taille);
+    materialiser();
+    return taille;
+}
+
+//! \brief remplace le graphe par une représentation figée écrite par sauvegarder(), lue sur place sans copie
+//! \brief la zone doit survivre au graphe et à ses copies; elle n'est jamais modifiée (une modification des arcs
+//! \brief figés copie d'abord la représentation dans le graphe)
+//! \param[in] p_donnees: le début de la représentation, aligné sur 4 octets (p. ex. dans un fichier projeté en mémoire)
+//! \param[in] p_taille: le nombre d'octets disponibles à partir de p_donnees
+//! \return le nombre d'octets de la représentation
+//! \throws logic_error lorsque les données sont tronquées, incohérentes ou mal alignées
+size_t Graphe::projeter(const char *p_donnees, size_t p_taille)
+{
+    if (reinterpret_cast<uintptr_t>(p_donnees) % alignof(uint32_t) != 0)
+        throw logic_error("Graphe::projeter(): données mal alignées");
+    const size_t taille = verifierRepresentation(p_donnees, p_taille);
+    uint64_t tailles[2];
+    memcpy(tailles, p_donnees, sizeof(tailles));
+    const uint32_t *debutArcs = reinterpret_cast<const uint32_t *>(p_donnees + sizeof(tailles));
+
+    vector<uint32_t>().swap(m_debutArcs);
+    vector<uint32_t>().swap(m_destinations);
+    vector<uint32_t>().swap(m_poidsFiges);
+    m_fige = {debutArcs, debutArcs + tailles[0] + 1, debutArcs + tailles[0] + 1 + tailles[1]};
+    m_projete = true;
+    m_nbSommetsFiges = tailles[0];
+    m_nbArcs = tailles[1];
+    vector<list<Arc> >(m_nbSommetsFiges).swap(m_listesAdj);
+    return taille;
+}
+
+//! \return true si la représentation figée est lue sur place dans une zone externe (projeter())
+bool Graphe::estProjete() const
+{
+    return m_projete;
+}
+
 //! \brief ajoute un arc d'un poids donné dans le graphe
 //! \param[in] i: le sommet origine de l'arc
 //! \param[in] j: le sommet destination de l'arc
@@ -69,9 +412,10 @@ void Graphe::ajouterArc(size_t i, size_t j, unsigned int poids)
 //! \param[in] i: le sommet origine de l'arc
 //! \param[in] j: le sommet destination de l'arc
 //! \pre l'arc (i,j) et les sommets i et j dovent exister
+//! \pre l'arc (i,j) doit avoir été ajouté après le dernier appel à figer()
 //! \post enlève l'arc mais n'enlève jamais le sommet i
 //! \throws logic_error lorsque le sommet i ou le sommet j n'existe pas
-//! \throws logic_error lorsque l'arc n'existe pas
+//! \throws logic_error lorsque l'arc n'existe pas ou est figé
 void Graphe::enleverArc(size_t i, size_t j)
 {
     if (i >= m_listesAdj.size())
@@ -80,7 +424,7 @@ void Graphe::enleverArc(size_t i, size_t j)
         throw logic_error("Graphe::enleverArc(): tentative d'enlever l'arc(i,j) avec un sommet j inexistant");
     auto &liste = m_listesAdj[i];
     bool arc_enleve = false;
-    if(liste.empty()) throw logic_error("Graphe:enleverArc(): m_listesAdj[i] est vide");
+    if(liste.empty() && i >= m_nbSommetsFiges) throw logic_error("Graphe:enleverArc(): m_listesAdj[i] est vide");
     for (auto itr = liste.end(); itr != liste.begin();) //on débute par la fin par choix
     {
         if ((--itr)->destination == j)
@@ -90,6 +434,10 @@ void Graphe::enleverArc(size_t i, size_t j)
             break;
         }
     }
+    if (!arc_enleve && i < m_nbSommetsFiges &&
+        find(m_fige.destinations + m_fige.debutArcs[i], m_fige.destinations + m_fige.debutArcs[i + 1], j) !=
+        m_fige.destinations + m_fige.debutArcs[i + 1])
+        throw logic_error("Graphe::enleverArc: cet arc est figé; donc impossible de l'enlever");
     if (!arc_enleve)
         throw logic_error("Graphe::enleverArc: cet arc n'existe pas; donc impossible de l'enlever");
     --m_nbArcs;
@@ -99,6 +447,13 @@ void Graphe::enleverArc(size_t i, size_t j)
 unsigned int Graphe::getPoids(size_t i, size_t j) const
 {
     if (i >= m_listesAdj.size()) throw logic_error("Graphe::getPoids(): l'incice i n,est pas un sommet existant");
+    if (i < m_nbSommetsFiges)
+    {
+        for (uint32_t k = m_fige.debutArcs[i]; k < m_fige.debutArcs[i + 1]; ++k)
+        {
+            if (m_fige.destinations[k] == j) return m_fige.poids[k];
+        }
+    }
     for (auto & arc : m_listesAdj[i])
     {
         if (arc.destination == j) return arc.poids;
@@ -107,71 +462,442 @@ unsigned int Graphe::getPoids(size_t i, size_t j) const
 }
 
 
+TasRadix::TasRadix()
+        : m_derniereCle(0), m_taille(0)
+{
+}
+
+void TasRadix::clear()
+{
+    for (auto &seau : m_seaux) seau.clear();
+    m_derniereCle = 0;
+    m_taille = 0;
+}
+
+bool TasRadix::empty() const
+{
+    return m_taille == 0;
+}
+
+size_t TasRadix::size() const
+{
+    return m_taille;
+}
+
+//! \brief indice du seau d'une clé: nombre de bits significatifs de p_cle XOR p_derniere
+size_t TasRadix::indiceSeau(unsigned int p_cle, unsigned int p_derniere)
+{
+    unsigned int difference = p_cle ^ p_derniere;
+    if (difference == 0) return 0;
+#if defined(__GNUC__)
+    return 32 - __builtin_clz(difference);
+#else
+    size_t indice = 0;
+    for (; difference; difference >>= 1) ++indice;
+    return indice;
+#endif
+}
+
+//! \brief insère p_valeur avec la priorité p_cle
+//! \throws logic_error lorsque p_cle est inférieure à la dernière clé extraite (file non monotone)
+void TasRadix::push(unsigned int p_cle, size_t p_valeur)
+{
+    if (p_cle < m_derniereCle)
+        throw logic_error("TasRadix::push(): clé inférieure à la dernière clé extraite");
+    m_seaux[indiceSeau(p_cle, m_derniereCle)].emplace_back(p_cle, p_valeur);
+    ++m_taille;
+}
+
+//! \brief retire et retourne une paire (clé, valeur) de clé minimale
+//! \pre la file n'est pas vide
+std::pair<unsigned int, size_t> TasRadix::pop()
+{
+    if (m_seaux[0].empty())
+    {
+        size_t i = 1;
+        while (m_seaux[i].empty()) ++i;
+        //la nouvelle dernière clé est le minimum du premier seau non vide; on y redistribue ses éléments
+        unsigned int minimum = m_seaux[i].front().first;
+        for (const auto &element : m_seaux[i]) minimum = min(minimum, element.first);
+        m_derniereCle = minimum;
+        for (const auto &element : m_seaux[i])
+            m_seaux[indiceSeau(element.first, m_derniereCle)].push_back(element);
+        m_seaux[i].clear();
+    }
+    std::pair<unsigned int, size_t> element = m_seaux[0].back();
+    m_seaux[0].pop_back();
+    --m_taille;
+    return element;
+}
+
+ContexteRecherche::ContexteRecherche(FileDePriorite p_file)
+        : m_versionCourante(0), m_file(p_file)
+{
+}
+
+void ContexteRecherche::setFileDePriorite(FileDePriorite p_file)
+{
+    m_file = p_file;
+}
+
+FileDePriorite ContexteRecherche::getFileDePriorite() const
+{
+    return m_file;
+}
+
+//! \brief effort de la dernière recherche (nul si le programme n'est pas compilé avec -DSTATISTIQUES_RECHERCHE)
+const StatistiquesRecherche &ContexteRecherche::getStatistiques() const
+{
+    return m_statistiques;
+}
+
+ostream &operator<<(ostream &p_flux, const StatistiquesRecherche &p_statistiques)
+{
+    return p_flux << "sommets traités: " << p_statistiques.sommetsTraites << ", arcs relâchés: "
+                  << p_statistiques.arcsRelaches << ", insertions: " << p_statistiques.insertions << ", extractions: "
+                  << p_statistiques.extractions << " (périmées: " << p_statistiques.extractionsPerimees
+                  << "), taille max de la file: " << p_statistiques.tailleMaxFile << ", préparation: "
+                  << p_statistiques.microsecondesPreparation << " us, recherche: "
+                  << p_statistiques.microsecondesRecherche << " us, reconstruction: "
+                  << p_statistiques.microsecondesReconstruction << " us";
+}
+
+//! \brief prépare le contexte pour une nouvelle recherche sur un graphe de p_nbSommets sommets
+//! \post toutes les distances sont considérées infinies sans réinitialiser les tableaux
+void ContexteRecherche::preparer(size_t p_nbSommets)
+{
+    if (m_versions.size() < p_nbSommets)
+    {
+        m_distances.resize(p_nbSommets);
+        m_predecesseurs.resize(p_nbSommets);
+        m_versions.resize(p_nbSommets, 0);
+        m_poidsVersDestination.resize(p_nbSommets);
+        m_versionsDestination.resize(p_nbSommets, 0);
+        m_rangsCibles.resize(p_nbSommets);
+    }
+    if (++m_versionCourante == 0) //débordement du compteur: on réinitialise une seule fois les versions
+    {
+        fill(m_versions.begin(), m_versions.end(), 0);
+        fill(m_versionsDestination.begin(), m_versionsDestination.end(), 0);
+        m_versionCourante = 1;
+    }
+    m_tas.clear();
+    m_tasRadix.clear();
+    COMPTER(m_statistiques = StatistiquesRecherche());
+}
+
+void ContexteRecherche::pousser(unsigned int p_distance, size_t p_sommet)
+{
+    if (m_file == FileDePriorite::Radix)
+    {
+        m_tasRadix.push(p_distance, p_sommet);
+    }
+    else
+    {
+        m_tas.emplace_back(p_distance, p_sommet);
+        push_heap(m_tas.begin(), m_tas.end(), greater<pair<unsigned int, size_t> >());
+    }
+    COMPTER(++m_statistiques.insertions);
+    COMPTER(m_statistiques.tailleMaxFile = max(m_statistiques.tailleMaxFile,
+                                               m_file == FileDePriorite::Radix ? m_tasRadix.size() : m_tas.size()));
+}
+
+pair<unsigned int, size_t> ContexteRecherche::extraire()
+{
+    COMPTER(++m_statistiques.extractions);
+    if (m_file == FileDePriorite::Radix) return m_tasRadix.pop();
+    pop_heap(m_tas.begin(), m_tas.end(), greater<pair<unsigned int, size_t> >());
+    pair<unsigned int, size_t> element = m_tas.back();
+    m_tas.pop_back();
+    return element;
+}
+
+bool ContexteRecherche::fileVide() const
+{
+    return m_file == FileDePriorite::Radix ? m_tasRadix.empty() : m_tas.empty();
+}
+
+unsigned int ContexteRecherche::getDistance(size_t i) const
+{
+    return m_versions[i] == m_versionCourante ? m_distances[i] : numeric_limits<unsigned int>::max();
+}
+
+void ContexteRecherche::setDistance(size_t i, unsigned int p_distance, size_t p_predecesseur)
+{
+    m_versions[i] = m_versionCourante;
+    m_distances[i] = p_distance;
+    m_predecesseurs[i] = p_predecesseur;
+}
+
+//! \brief ajoute deux postes à p_rapport: les listes d'adjacence (p_nom) et la représentation figée (p_nom figé)
+void Graphe::evaluerMemoire(RapportMemoire &p_rapport, const string &p_nom) const
+{
+    PosteMemoire &listes = p_rapport.ajouter(p_nom);
+    RapportMemoire::compter(listes, m_listesAdj);
+    for (const auto &liste : m_listesAdj)
+    {
+        listes.elements += liste.size();
+        RapportMemoire::compter(listes, liste);
+    }
+
+    //une représentation projetée est dans le cache de pages du fichier et non dans le tas: aucun octet compté
+    PosteMemoire &fige = p_rapport.ajouter(p_nom + (m_projete ? " figé (projeté)" : " figé"));
+    fige.elements = getNbArcsFiges();
+    RapportMemoire::compter(fige, m_debutArcs);
+    RapportMemoire::compter(fige, m_destinations);
+    RapportMemoire::compter(fige, m_poidsFiges);
+}
+
+//! \brief remplit p_poste avec la mémoire d'un graphe de p_nbSommets sommets et p_nbArcs arcs, tel que laissé par
+//! \brief figer(): (n + 1) débuts et 2 m destinations et poids sur 32 bits, plus les listes d'adjacence vides
+//! \brief (pour un graphe dont on ne connaît que ces nombres, p. ex. celui de ReseauGTFS)
+void Graphe::estimerMemoireFigee(size_t p_nbSommets, size_t p_nbArcs, PosteMemoire &p_poste)
+{
+    p_poste.elements += p_nbArcs;
+    RapportMemoire::compterBloc(p_poste, (p_nbSommets + 1) * sizeof(uint32_t));
+    RapportMemoire::compterBloc(p_poste, p_nbArcs * sizeof(uint32_t));
+    RapportMemoire::compterBloc(p_poste, p_nbArcs * sizeof(uint32_t));
+    RapportMemoire::compterBloc(p_poste, p_nbSommets * sizeof(std::list<Arc>));
+}
+
+//! \brief plus court chemin utilisant un contexte propre au fil d'exécution appelant
+//! \brief voir plusCourtChemin(size_t, size_t, std::vector<size_t> &, ContexteRecherche &)
+unsigned int Graphe::plusCourtChemin(size_t origin, size_t destination, std::vector<size_t> &path) const
+{
+    thread_local ContexteRecherche contexte;
+    return plusCourtChemin(origin, destination, path, contexte);
+}
+
 //! \brief Version amméliorée de l'algorithme de Dijkstra permettant de trouver le plus court chemin entre p_origine et p_destination
 //! \pre p_origine et p_destination doivent être des sommets du graphe
 //! \return la longueur du plus court chemin est retournée
 //! \param[out] le chemin est retourné (un seul noeud si p_destination == p_origine ou si p_destination est inatteignable)
 //! \return la longueur du chemin (= numeric_limits<unsigned int>::max() si p_destination n'est pas atteignable)
+//! \param[in,out] p_contexte: l'espace de travail de la recherche, réutilisé d'un appel à l'autre
 //! \throws logic_error lorsque p_origine ou p_destination n'existe pas
-unsigned int Graphe::plusCourtChemin(size_t origin, size_t destination, std::vector<size_t> &path) const {
-    const unsigned int INFINITY = std::numeric_limits<unsigned int>::max();
+unsigned int Graphe::plusCourtChemin(size_t origin, size_t destination, std::vector<size_t> &path,
+                                     ContexteRecherche &contexte) const {
     const size_t UNDEFINED = std::numeric_limits<size_t>::max();
 
+    if (origin >= m_listesAdj.size() || destination >= m_listesAdj.size())
+        throw logic_error("Graphe::plusCourtChemin(): p_origine ou p_destination n'est pas un sommet existant");
+
     path.clear();
 
     if (origin == destination) {
+        COMPTER(contexte.m_statistiques = StatistiquesRecherche());
         path.push_back(destination);
         return 0;
     }
 
-    std::vector<unsigned int> dist(m_listesAdj.size(), INFINITY);
-    std::vector<size_t> prev(m_listesAdj.size(), UNDEFINED);
+    contexte.preparer(m_listesAdj.size());
+    contexte.setDistance(origin, 0, UNDEFINED);
+    contexte.pousser(0, origin);
+
+    COMPTER(auto debut = chrono::steady_clock::now());
+    executerDijkstra(destination, nullptr, nullptr, contexte);
+    COMPTER(contexte.m_statistiques.microsecondesRecherche = microsecondesDepuis(debut));
+    COMPTER(debut = chrono::steady_clock::now());
+    unsigned int longueur = reconstruireChemin(destination, path, contexte);
+    COMPTER(contexte.m_statistiques.microsecondesReconstruction = microsecondesDepuis(debut));
+    return longueur;
+}
+
+//! \brief plus court chemin entre le sommet origine virtuel et le sommet destination virtuel d'une surcouche
+//! \brief le graphe n'est pas modifié; il peut donc être partagé entre plusieurs fils d'exécution
+//! \param[in] p_surcouche: les arcs propres à la requête
+//! \param[out] p_chemin: débute par getNbSommets() et se termine par getNbSommets() + 1 lorsque la destination est atteignable
+//! \param[in,out] p_contexte: l'espace de travail de la recherche
+//! \param[in] p_heuristique: si non nul, recherche A* guidée par cette borne inférieure consistante;
+//!                           la longueur retournée est alors identique à celle de Dijkstra
+//! \return la longueur du chemin (= numeric_limits<unsigned int>::max() si la destination n'est pas atteignable)
+//! \throws logic_error lorsqu'un arc de la surcouche mène à un sommet inexistant
+unsigned int Graphe::plusCourtChemin(const Surcouche &p_surcouche, std::vector<size_t> &p_chemin,
+                                     ContexteRecherche &p_contexte, const Heuristique *p_heuristique) const
+{
+    const size_t UNDEFINED = std::numeric_limits<size_t>::max();
+    const size_t origine = m_listesAdj.size();
+    const size_t destination = origine + 1;
+
+    p_chemin.clear();
+    p_contexte.preparer(origine + 2);
+    p_contexte.setDistance(origine, 0, UNDEFINED);
+
+    for (const auto &arc : p_surcouche.arcsDestination)
+    {
+        if (arc.first >= origine)
+            throw logic_error("Graphe::plusCourtChemin(): arc de surcouche vers la destination avec un sommet inexistant");
+        if (p_contexte.m_versionsDestination[arc.first] != p_contexte.m_versionCourante ||
+            arc.second < p_contexte.m_poidsVersDestination[arc.first])
+        {
+            p_contexte.m_versionsDestination[arc.first] = p_contexte.m_versionCourante;
+            p_contexte.m_poidsVersDestination[arc.first] = arc.second;
+        }
+    }
+
+    for (const auto &arc : p_surcouche.arcsOrigine)
+    {
+        if (arc.first >= origine)
+            throw logic_error("Graphe::plusCourtChemin(): arc de surcouche depuis l'origine avec un sommet inexistant");
+        if (arc.second < p_contexte.getDistance(arc.first))
+        {
+            p_contexte.setDistance(arc.first, arc.second, origine);
+            p_contexte.pousser(arc.second + (p_heuristique ? p_heuristique->borne(arc.first) : 0), arc.first);
+        }
+    }
+
+    COMPTER(auto debut = chrono::steady_clock::now());
+    executerDijkstra(destination, &p_surcouche, p_heuristique, p_contexte);
+    COMPTER(p_contexte.m_statistiques.microsecondesRecherche = microsecondesDepuis(debut));
+    COMPTER(debut = chrono::steady_clock::now());
+    unsigned int longueur = reconstruireChemin(destination, p_chemin, p_contexte);
+    COMPTER(p_contexte.m_statistiques.microsecondesReconstruction = microsecondesDepuis(debut));
+    return longueur;
+}
 
-    dist[origin] = 0;
+//! \brief distances depuis le sommet origine virtuel d'une surcouche vers plusieurs destinations, en une seule
+//! \brief recherche; les arcs vers la destination virtuelle de la surcouche sont ignorés
+//! \brief La recherche s'arrête lorsque toutes les cibles sont traitées, ou lorsque chaque destination reliée à une
+//! \brief cible a une distance et que la distance courante atteint la plus grande d'entre elles: les cibles non
+//! \brief encore traitées, plus éloignées, ne peuvent plus raccourcir aucune destination.
+//! \param[in] p_surcouche: seuls ses arcs origine sont utilisés
+//! \param[in] p_cibles: les destinations et les sommets qui y mènent
+//! \param[out] p_distances: p_distances[d] est la distance de la destination d (numeric_limits<unsigned int>::max()
+//! \param[out] si inatteignable)
+//! \param[in,out] p_contexte: l'espace de travail de la recherche
+//! \throws logic_error lorsqu'un arc de la surcouche ou une cible n'existe pas
+void Graphe::plusCourtesDistances(const Surcouche &p_surcouche, const CiblesDistances &p_cibles,
+                                  vector<unsigned int> &p_distances, ContexteRecherche &p_contexte) const
+{
+    const size_t UNDEFINED = std::numeric_limits<size_t>::max();
+    const size_t origine = m_listesAdj.size();
 
-    std::priority_queue<
-            std::pair<int, size_t>,
-            std::vector<std::pair<int, size_t>>,
-            std::greater<std::pair<int, size_t>>>
-            nodeQueue;
+    p_contexte.preparer(origine + 2);
+    for (uint32_t k = 0; k < p_cibles.sommets.size(); ++k)
+    {
+        const uint32_t cible = p_cibles.sommets[k];
+        if (cible >= origine)
+            throw logic_error("Graphe::plusCourtesDistances(): sommet cible inexistant");
+        p_contexte.m_versionsDestination[cible] = p_contexte.m_versionCourante;
+        p_contexte.m_rangsCibles[cible] = k;
+    }
+    p_contexte.setDistance(origine, 0, UNDEFINED);
+    for (const auto &arc : p_surcouche.arcsOrigine)
+    {
+        if (arc.first >= origine)
+            throw logic_error("Graphe::plusCourtesDistances(): arc de surcouche depuis l'origine avec un sommet inexistant");
+        if (arc.second < p_contexte.getDistance(arc.first))
+        {
+            p_contexte.setDistance(arc.first, arc.second, origine);
+            p_contexte.pousser(arc.second, arc.first);
+        }
+    }
 
-    nodeQueue.emplace(0, origin);
+    p_distances.assign(p_cibles.nbDestinations, numeric_limits<unsigned int>::max());
+    COMPTER(const auto debut = chrono::steady_clock::now());
+    executerDijkstra(UNDEFINED, nullptr, nullptr, p_contexte, &p_cibles, &p_distances);
+    COMPTER(p_contexte.m_statistiques.microsecondesRecherche = microsecondesDepuis(debut));
+}
 
-    while (!nodeQueue.empty()) {
-        size_t current = nodeQueue.top().second;
-        nodeQueue.pop();
+//! \brief boucle principale de Dijkstra (ou A*) à partir des sommets déjà placés dans la file du contexte
+//! \brief la priorité d'un sommet est sa distance, plus sa borne inférieure en mode A*
+//! \brief les entrées périmées (priorité supérieure à la priorité courante du sommet) sont ignorées
+//! \param[in] p_destination: la recherche s'arrête lorsque ce sommet est retiré de la file
+//! \param[in] p_surcouche: si non nul, les sommets marqués dans le contexte sont reliés à la destination virtuelle
+//! \param[in] p_heuristique: si non nul, la borne inférieure utilisée par A*
+//! \param[in] p_cibles: si non nul, les cibles marquées dans le contexte (sans surcouche ni heuristique) mettent à
+//! \param[in] jour p_distances, et la recherche s'arrête comme décrit dans plusCourtesDistances()
+void Graphe::executerDijkstra(size_t destination, const Surcouche *p_surcouche, const Heuristique *p_heuristique,
+                              ContexteRecherche &contexte, const CiblesDistances *p_cibles,
+                              std::vector<unsigned int> *p_distances) const {
+    const size_t nbSommets = m_listesAdj.size();
+    const unsigned int INFINITY = std::numeric_limits<unsigned int>::max();
 
+    size_t ciblesRestantes = 0;
+    size_t destinationsInconnues = 0; //destinations reliées à une cible mais encore sans distance
+    unsigned int borneCibles = INFINITY; //plus grande distance des destinations, une fois toutes connues
+    if (p_cibles) {
+        ciblesRestantes = p_cibles->sommets.size();
+        std::vector<uint8_t> reliee(p_cibles->nbDestinations, 0);
+        for (const auto &arc : p_cibles->arcs) {
+            if (!reliee[arc.first]) ++destinationsInconnues;
+            reliee[arc.first] = 1;
+        }
+        if (ciblesRestantes == 0) return;
+    }
+
+    while (!contexte.fileVide()) {
+        const std::pair<unsigned int, size_t> entree = contexte.extraire();
+        const size_t current = entree.second;
+        const unsigned int currentDist = contexte.getDistance(current);
+        const unsigned int currentBorne = p_heuristique ? p_heuristique->borne(current) : 0;
+
+        if (entree.first > currentDist + currentBorne) {
+            COMPTER(++contexte.m_statistiques.extractionsPerimees);
+            continue; //entrée périmée: le sommet a déjà été traité avec une distance plus petite
+        }
+        COMPTER(++contexte.m_statistiques.sommetsTraites);
         if (current == destination) {
             break;
         }
 
-        for (const auto& edge : m_listesAdj[current]) {
-            size_t neighbor = edge.destination;
-            unsigned int newDist = dist[current] + edge.poids;
+        if (p_cibles && current < nbSommets) {
+            if (currentDist >= borneCibles) break;
+            if (contexte.m_versionsDestination[current] == contexte.m_versionCourante) {
+                const uint32_t rang = contexte.m_rangsCibles[current];
+                for (uint32_t k = p_cibles->debut[rang]; k < p_cibles->debut[rang + 1]; ++k) {
+                    unsigned int &distance = (*p_distances)[p_cibles->arcs[k].first];
+                    if (distance == INFINITY) --destinationsInconnues;
+                    distance = std::min(distance, currentDist + p_cibles->arcs[k].second);
+                }
+                if (--ciblesRestantes == 0) break;
+                if (destinationsInconnues == 0) {
+                    borneCibles = 0; //les destinations sans cible restent infinies et sont ignorées
+                    for (unsigned int distance : *p_distances)
+                        if (distance != INFINITY) borneCibles = std::max(borneCibles, distance);
+                }
+            }
+        }
 
-            if (newDist < dist[neighbor]) {
-                dist[neighbor] = newDist;
-                prev[neighbor] = current;
-                nodeQueue.emplace(newDist, neighbor);
+        auto relacher = [&](size_t neighbor, unsigned int poids) {
+            COMPTER(++contexte.m_statistiques.arcsRelaches);
+            unsigned int newDist = currentDist + poids;
+
+            if (newDist < contexte.getDistance(neighbor)) {
+                contexte.setDistance(neighbor, newDist, current);
+                contexte.pousser(newDist + (p_heuristique ? p_heuristique->borne(neighbor) : 0), neighbor);
             }
+        };
+
+        if (current >= nbSommets) continue; //l'origine virtuelle n'a pas d'autres arcs que ceux déjà relâchés
+        parcourirArcs(current, relacher);
+        if (p_surcouche && contexte.m_versionsDestination[current] == contexte.m_versionCourante) {
+            relacher(nbSommets + 1, contexte.m_poidsVersDestination[current]);
         }
     }
+}
+
+//! \brief reconstruit le chemin se terminant à p_destination à partir des prédécesseurs du contexte
+//! \return la distance de p_destination (= numeric_limits<unsigned int>::max() si inatteignable)
+unsigned int Graphe::reconstruireChemin(size_t destination, std::vector<size_t> &path,
+                                        const ContexteRecherche &contexte) const {
+    const unsigned int INFINITY = std::numeric_limits<unsigned int>::max();
+    const size_t UNDEFINED = std::numeric_limits<size_t>::max();
 
-    if (prev[destination] == UNDEFINED) {
+    if (contexte.getDistance(destination) == INFINITY) {
         path.push_back(destination);
         return INFINITY;
     }
 
     std::stack<size_t> pathStack;
-    for (size_t node = destination; prev[node] != UNDEFINED; node = prev[node]) {
+    for (size_t node = destination; node != UNDEFINED; node = contexte.m_predecesseurs[node]) {
         pathStack.push(node);
     }
-    pathStack.push(origin);
 
     while (!pathStack.empty()) {
         path.push_back(pathStack.top());
         pathStack.pop();
     }
 
-    return dist[destination];
+    return contexte.getDistance(destination);
 }
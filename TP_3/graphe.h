@@ -9,6 +9,7 @@
 #define GRAPH_H
 
 #include <vector>
+#include <string>
 #include <list>
 #include <set>
 #include <stack>
@@ -16,6 +17,161 @@
 #include <limits>
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+
+class RapportMemoire;
+struct PosteMemoire;
+
+//! \brief  Arcs propres à une requête, consultés par Graphe::plusCourtChemin sans modifier le graphe
+//! \brief  Le sommet origine virtuel est Graphe::getNbSommets() et le sommet destination virtuel est Graphe::getNbSommets() + 1
+struct Surcouche
+{
+    std::vector<std::pair<size_t, unsigned int> > arcsOrigine;     /*!< (sommet, poids) des arcs origine virtuelle -> sommet */
+    std::vector<std::pair<size_t, unsigned int> > arcsDestination; /*!< (sommet, poids) des arcs sommet -> destination virtuelle */
+
+    void clear()
+    {
+        arcsOrigine.clear();
+        arcsDestination.clear();
+    }
+};
+
+//! \brief  Destinations de Graphe::plusCourtesDistances, reliées à des sommets cibles du graphe
+//! \brief  La cible sommets[k] est reliée aux destinations arcs[debut[k] .. debut[k+1]) (destination, poids).
+struct CiblesDistances
+{
+    std::vector<uint32_t> sommets;  /*!< sans doublon */
+    std::vector<uint32_t> debut;    /*!< sommets.size() + 1 débuts de plages dans arcs */
+    std::vector<std::pair<uint32_t, unsigned int> > arcs;
+    uint32_t nbDestinations = 0;
+};
+
+//! \brief  Borne inférieure (heuristique A*) de la distance restante jusqu'à la destination d'une requête
+//! \brief  Les sommets sont regroupés (p. ex. par station): borne(i) = bornesParGroupe[(*groupeDuSommet)[i]].
+//! \brief  La borne doit être consistante (borne(i) <= poids(i,j) + borne(j)) et nulle à la destination;
+//! \brief  les sommets sans groupe (sommets virtuels) ont une borne nulle.
+struct Heuristique
+{
+    const std::vector<uint32_t> *groupeDuSommet = nullptr;
+    std::vector<unsigned int> bornesParGroupe;
+    std::vector<std::pair<unsigned int, uint32_t> > aCorriger; /*!< espace de travail de qui construit les bornes */
+
+    unsigned int borne(size_t i) const
+    {
+        return i < groupeDuSommet->size() ? bornesParGroupe[(*groupeDuSommet)[i]] : 0;
+    }
+};
+
+//! \brief  File de priorité monotone (radix heap) pour des clés entières non négatives
+//! \brief  Les clés insérées ne doivent jamais être inférieures à la dernière clé extraite, ce qui est le cas
+//! \brief  pour Dijkstra avec des poids non négatifs. Chaque élément change de seau au plus 32 fois.
+class TasRadix
+{
+public:
+
+    TasRadix();
+    void clear();
+    bool empty() const;
+    size_t size() const;
+    void push(unsigned int p_cle, size_t p_valeur);
+    std::pair<unsigned int, size_t> pop();
+
+private:
+
+    static size_t indiceSeau(unsigned int p_cle, unsigned int p_derniere);
+
+    static const size_t nbSeaux = 33; /*!< seau 0: clé == dernière extraite; seau b: le bit b-1 est le plus haut qui diffère */
+    std::vector<std::pair<unsigned int, size_t> > m_seaux[nbSeaux];
+    unsigned int m_derniereCle;
+    size_t m_taille;
+};
+
+//! \brief  Arcs accumulés par un fil d'exécution, puis intégrés au graphe par Graphe::figer(const std::vector<TamponArcs>&)
+struct TamponArcs
+{
+    std::vector<uint32_t> origines;
+    std::vector<uint32_t> destinations;
+    std::vector<uint32_t> poids;
+
+    void ajouter(size_t i, size_t j, unsigned int p_poids)
+    {
+        origines.push_back(static_cast<uint32_t>(i));
+        destinations.push_back(static_cast<uint32_t>(j));
+        poids.push_back(p_poids);
+    }
+    size_t size() const
+    {
+        return origines.size();
+    }
+};
+
+//! \brief  Vrai lorsque le programme est compilé avec -DSTATISTIQUES_RECHERCHE
+#ifdef STATISTIQUES_RECHERCHE
+constexpr bool statistiquesRechercheActives = true;
+#else
+constexpr bool statistiquesRechercheActives = false;
+#endif
+
+//! \brief  Effort de la dernière recherche d'un ContexteRecherche
+//! \brief  Les compteurs ne sont remplis que si statistiquesRechercheActives; sinon ils restent nuls et leur mise à
+//! \brief  jour est retirée à la compilation.
+struct StatistiquesRecherche
+{
+    size_t sommetsTraites = 0;       /*!< sommets retirés de la file avec leur distance définitive */
+    size_t arcsRelaches = 0;         /*!< arcs examinés depuis un sommet traité */
+    size_t insertions = 0;           /*!< insertions dans la file de priorité */
+    size_t extractions = 0;          /*!< extractions de la file de priorité, périmées ou non */
+    size_t extractionsPerimees = 0;  /*!< entrées ignorées car le sommet avait déjà été traité */
+    size_t tailleMaxFile = 0;
+    long microsecondesPreparation = 0;    /*!< construction de la surcouche et de l'heuristique (ReseauPartage) */
+    long microsecondesRecherche = 0;
+    long microsecondesReconstruction = 0; /*!< reconstruction du chemin à partir des prédécesseurs */
+};
+
+std::ostream &operator<<(std::ostream &p_flux, const StatistiquesRecherche &p_statistiques);
+
+//! \brief  Choix de la file de priorité utilisée par Graphe::plusCourtChemin
+enum class FileDePriorite
+{
+    Monceau, /*!< monceau binaire (std::push_heap / std::pop_heap) */
+    Radix    /*!< TasRadix, exploite les poids entiers en secondes */
+};
+
+//! \brief  Espace de travail réutilisable pour Graphe::plusCourtChemin
+//! \brief  Un contexte appartient à un seul fil d'exécution; plusieurs contextes peuvent interroger le même graphe
+//! \brief  simultanément. Les tableaux sont réinitialisés paresseusement grâce à un numéro de version par sommet.
+class ContexteRecherche
+{
+public:
+
+    explicit ContexteRecherche(FileDePriorite p_file = FileDePriorite::Radix);
+    void setFileDePriorite(FileDePriorite p_file);
+    FileDePriorite getFileDePriorite() const;
+    const StatistiquesRecherche &getStatistiques() const;
+
+private:
+
+    friend class Graphe;
+
+    void preparer(size_t p_nbSommets);
+    void pousser(unsigned int p_distance, size_t p_sommet);
+    std::pair<unsigned int, size_t> extraire();
+    bool fileVide() const;
+    unsigned int getDistance(size_t i) const;
+    void setDistance(size_t i, unsigned int p_distance, size_t p_predecesseur);
+
+    std::vector<unsigned int> m_distances;
+    std::vector<size_t> m_predecesseurs;
+    std::vector<uint32_t> m_versions;     /*!< m_distances[i] est valide ssi m_versions[i] == m_versionCourante */
+    std::vector<unsigned int> m_poidsVersDestination; /*!< poids de l'arc de surcouche i -> destination virtuelle */
+    std::vector<uint32_t> m_versionsDestination;     /*!< m_poidsVersDestination[i] est valide ssi == m_versionCourante */
+    std::vector<uint32_t> m_rangsCibles; /*!< rang du sommet i dans CiblesDistances::sommets, valide comme le poids */
+    uint32_t m_versionCourante;
+    FileDePriorite m_file;
+    std::vector<std::pair<unsigned int, size_t> > m_tas; /*!< monceau min de (distance, sommet) */
+    TasRadix m_tasRadix;
+    StatistiquesRecherche m_statistiques;
+};
 
 //! \brief  Classe pour graphes orientés pondérés (non négativement) avec listes d'adjacence
 class Graphe
@@ -23,18 +179,64 @@ class Graphe
 public:
 
 	explicit Graphe(size_t = 0);
+    Graphe(const Graphe & p_graphe);
+    Graphe(const Graphe & p_graphe, const std::vector<uint8_t> & p_sommetsRemplaces, const TamponArcs & p_arcs);
+    Graphe(Graphe && p_graphe) noexcept;
+    Graphe & operator=(const Graphe & p_graphe);
+    Graphe & operator=(Graphe && p_graphe) noexcept;
     void resize(size_t);
 	void ajouterArc(size_t i, size_t j, unsigned int poids);
 	void enleverArc(size_t i, size_t j);
 	unsigned int getPoids(size_t i, size_t j) const;
 	size_t getNbSommets() const;
     size_t getNbArcs() const;
+    void figer();
+    void figer(const std::vector<TamponArcs> & p_tampons);
+    void remplacerArcs(const std::vector<uint8_t> & p_sommetsRemplaces, const TamponArcs & p_arcs);
+    void modifierPoids(size_t i, size_t j, unsigned int p_poids);
+    bool estFige() const;
+    void sauvegarder(std::ostream & p_flux) const;
+    size_t charger(const char * p_donnees, size_t p_taille);
+    size_t projeter(const char * p_donnees, size_t p_taille);
+    bool estProjete() const;
+    void evaluerMemoire(RapportMemoire & p_rapport, const std::string & p_nom) const;
+    static void estimerMemoireFigee(size_t p_nbSommets, size_t p_nbArcs, PosteMemoire & p_poste);
 
     unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
                              std::vector<size_t> & p_chemin) const;
+    unsigned int plusCourtChemin(size_t p_origine, size_t p_destination,
+                             std::vector<size_t> & p_chemin, ContexteRecherche & p_contexte) const;
+    unsigned int plusCourtChemin(const Surcouche & p_surcouche,
+                             std::vector<size_t> & p_chemin, ContexteRecherche & p_contexte,
+                             const Heuristique * p_heuristique = nullptr) const;
+    void plusCourtesDistances(const Surcouche & p_surcouche, const CiblesDistances & p_cibles,
+                              std::vector<unsigned int> & p_distances, ContexteRecherche & p_contexte) const;
+
+    //! \brief applique p_fonction(destination, poids) sur chacun des arcs sortant du sommet i
+    template<typename Fonction>
+    void parcourirArcs(size_t i, Fonction p_fonction) const
+    {
+        if (i < m_nbSommetsFiges)
+        {
+            for (uint32_t k = m_fige.debutArcs[i]; k < m_fige.debutArcs[i + 1]; ++k)
+                p_fonction(static_cast<size_t>(m_fige.destinations[k]), static_cast<unsigned int>(m_fige.poids[k]));
+        }
+        for (const auto &arc : m_listesAdj[i])
+            p_fonction(arc.destination, arc.poids);
+    }
 
 private:
 
+    void executerDijkstra(size_t p_destination, const Surcouche * p_surcouche, const Heuristique * p_heuristique,
+                          ContexteRecherche & p_contexte, const CiblesDistances * p_cibles = nullptr,
+                          std::vector<unsigned int> * p_distances = nullptr) const;
+    unsigned int reconstruireChemin(size_t p_destination, std::vector<size_t> & p_chemin,
+                                    const ContexteRecherche & p_contexte) const;
+    size_t verifierRepresentation(const char * p_donnees, size_t p_taille) const;
+    void lierTableaux();
+    void materialiser();
+    size_t getNbArcsFiges() const;
+
 	struct Arc
 	{
 		Arc(size_t dest, unsigned int p) :
@@ -45,9 +247,24 @@ private:
 		unsigned int poids;
 	};
 
-	std::vector<std::list<Arc> > m_listesAdj; /*!< les listes d'adjacence */
+	std::vector<std::list<Arc> > m_listesAdj; /*!< les listes d'adjacence (construction et arcs ajoutés après figer()) */
     unsigned long m_nbArcs;
 
+    //représentation figée (compressed sparse row) des arcs présents lors du dernier appel à figer()
+    //les arcs sortant du sommet i sont aux positions [debutArcs[i], debutArcs[i+1]) de destinations et poids
+    struct TableauxFiges
+    {
+        const uint32_t *debutArcs = nullptr;
+        const uint32_t *destinations = nullptr;
+        const uint32_t *poids = nullptr;
+    };
+    TableauxFiges m_fige;    /*!< lus par les recherches: les vecteurs ci-dessous, ou une zone projetée */
+    std::vector<uint32_t> m_debutArcs;
+    std::vector<uint32_t> m_destinations;
+    std::vector<uint32_t> m_poidsFiges;
+    size_t m_nbSommetsFiges; /*!< nombre de sommets couverts par la représentation figée */
+    bool m_projete;          /*!< m_fige désigne une zone externe (projeter()), partagée par les copies du graphe */
+
 };
 
 #endif  //GRAPH_H
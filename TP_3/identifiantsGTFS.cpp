@@ -0,0 +1,161 @@
+//
+//  IdentifiantsGTFS.cpp
+//  Identifiants entiers denses des stations, voyages et lignes de DonneesGTFS
+//
+
+#include "identifiantsGTFS.h"
+
+using namespace std;
+
+//! \brief attribue les indices et traduit les transferts et les stations de transfert
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \throws logic_error si un voyage ou un transfert désigne une ligne ou une station absente
+IdentifiantsGTFS::IdentifiantsGTFS(const DonneesGTFS &p_gtfs)
+{
+    m_indiceStation.reserve(p_gtfs.getStations().size());
+    for (const auto &station : p_gtfs.getStations())
+    {
+        m_indiceStation.emplace(station.first, static_cast<uint32_t>(m_stations.size()));
+        m_idsStations.push_back(&station.first);
+        m_stations.push_back(&station.second);
+    }
+
+    unordered_map<string, uint32_t> indiceNumero;
+    vector<uint32_t> numeroDeLigne;
+    for (const auto &ligne : p_gtfs.getLignes())
+    {
+        m_indiceLigne.emplace(ligne.first, static_cast<uint32_t>(m_lignes.size()));
+        m_lignes.push_back(&ligne.second);
+        auto numero = indiceNumero.emplace(ligne.second.getNumero(), static_cast<uint32_t>(m_numerosLigne.size()));
+        if (numero.second) m_numerosLigne.push_back(ligne.second.getNumero());
+        numeroDeLigne.push_back(numero.first->second);
+    }
+
+    m_indiceVoyage.reserve(p_gtfs.getVoyages().size());
+    for (const auto &voyage : p_gtfs.getVoyages())
+    {
+        m_indiceVoyage.emplace(voyage.first, static_cast<uint32_t>(m_voyages.size()));
+        m_voyages.push_back(&voyage.second);
+        const uint32_t ligne = indiceLigne(voyage.second.getLigne());
+        m_ligneDuVoyage.push_back(ligne);
+        m_numeroDuVoyage.push_back(numeroDeLigne[ligne]);
+    }
+
+    m_estStationDeTransfert.assign(m_stations.size(), 0);
+    for (const auto &stationId : p_gtfs.getStationsDeTransfert())
+    {
+        auto station = m_indiceStation.find(stationId);
+        if (station != m_indiceStation.end()) m_estStationDeTransfert[station->second] = 1;
+    }
+
+    m_transferts.reserve(p_gtfs.getTransferts().size());
+    for (const auto &transfert : p_gtfs.getTransferts())
+    {
+        m_transferts.push_back({indiceStation(get<0>(transfert)), indiceStation(get<1>(transfert)),
+                                static_cast<uint32_t>(get<2>(transfert))});
+    }
+}
+
+uint32_t IdentifiantsGTFS::getNbStations() const
+{
+    return static_cast<uint32_t>(m_stations.size());
+}
+
+uint32_t IdentifiantsGTFS::getNbVoyages() const
+{
+    return static_cast<uint32_t>(m_voyages.size());
+}
+
+uint32_t IdentifiantsGTFS::getNbLignes() const
+{
+    return static_cast<uint32_t>(m_lignes.size());
+}
+
+uint32_t IdentifiantsGTFS::getNbNumerosLigne() const
+{
+    return static_cast<uint32_t>(m_numerosLigne.size());
+}
+
+//! \throws logic_error si la station est absente de DonneesGTFS
+uint32_t IdentifiantsGTFS::indiceStation(const string &p_stationId) const
+{
+    auto station = m_indiceStation.find(p_stationId);
+    if (station == m_indiceStation.end())
+        throw logic_error("IdentifiantsGTFS::indiceStation(): station inconnue " + p_stationId);
+    return station->second;
+}
+
+//! \throws logic_error si le voyage est absent de DonneesGTFS
+uint32_t IdentifiantsGTFS::indiceVoyage(const string &p_voyageId) const
+{
+    auto voyage = m_indiceVoyage.find(p_voyageId);
+    if (voyage == m_indiceVoyage.end())
+        throw logic_error("IdentifiantsGTFS::indiceVoyage(): voyage inconnu " + p_voyageId);
+    return voyage->second;
+}
+
+//! \brief comme indiceVoyage(), sans exception pour un voyage absent
+//! \return false si le voyage est absent de DonneesGTFS (p_voyage est alors inchangé)
+bool IdentifiantsGTFS::chercherVoyage(const string &p_voyageId, uint32_t &p_voyage) const
+{
+    auto voyage = m_indiceVoyage.find(p_voyageId);
+    if (voyage == m_indiceVoyage.end()) return false;
+    p_voyage = voyage->second;
+    return true;
+}
+
+//! \throws logic_error si la ligne est absente de DonneesGTFS
+uint32_t IdentifiantsGTFS::indiceLigne(const string &p_ligneId) const
+{
+    auto ligne = m_indiceLigne.find(p_ligneId);
+    if (ligne == m_indiceLigne.end())
+        throw logic_error("IdentifiantsGTFS::indiceLigne(): ligne inconnue " + p_ligneId);
+    return ligne->second;
+}
+
+const string &IdentifiantsGTFS::idStation(uint32_t p_station) const
+{
+    return *m_idsStations[p_station];
+}
+
+const Station &IdentifiantsGTFS::station(uint32_t p_station) const
+{
+    return *m_stations[p_station];
+}
+
+const Voyage &IdentifiantsGTFS::voyage(uint32_t p_voyage) const
+{
+    return *m_voyages[p_voyage];
+}
+
+const Ligne &IdentifiantsGTFS::ligne(uint32_t p_ligne) const
+{
+    return *m_lignes[p_ligne];
+}
+
+const string &IdentifiantsGTFS::numeroLigne(uint32_t p_numero) const
+{
+    return m_numerosLigne[p_numero];
+}
+
+//! \return l'indice (ordre de DonneesGTFS::getLignes()) de la ligne du voyage
+uint32_t IdentifiantsGTFS::ligneDuVoyage(uint32_t p_voyage) const
+{
+    return m_ligneDuVoyage[p_voyage];
+}
+
+//! \return l'indice du numéro de la ligne du voyage; deux lignes de même numéro ont le même indice
+uint32_t IdentifiantsGTFS::numeroDuVoyage(uint32_t p_voyage) const
+{
+    return m_numeroDuVoyage[p_voyage];
+}
+
+bool IdentifiantsGTFS::estStationDeTransfert(uint32_t p_station) const
+{
+    return m_estStationDeTransfert[p_station] != 0;
+}
+
+const vector<TransfertIndexe> &IdentifiantsGTFS::getTransferts() const
+{
+    return m_transferts;
+}
@@ -0,0 +1,74 @@
+//
+//  IdentifiantsGTFS.h
+//  Identifiants entiers denses des stations, voyages et lignes de DonneesGTFS
+//
+
+#ifndef IDENTIFIANTSGTFS_H
+#define IDENTIFIANTSGTFS_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "DonneesGTFS.h"
+
+//! \brief Transfert entre deux stations désignées par leurs indices
+struct TransfertIndexe
+{
+    uint32_t stationDepart;
+    uint32_t stationArrivee;
+    uint32_t duree;          /*!< en secondes */
+};
+
+//! \brief Attribue à chaque station, voyage et ligne de DonneesGTFS un indice 32 bits dense, dans l'ordre des
+//! \brief conteneurs de DonneesGTFS (getStations(), getVoyages(), getLignes()). Les numéros de ligne (Ligne::getNumero(),
+//! \brief sur lesquels portent les règles de correspondance) reçoivent aussi un indice, dans l'ordre de leur première
+//! \brief apparition dans getLignes(). Les chaînes ne servent plus qu'à la traduction des identifiants et à l'affichage.
+//! \brief L'objet DonneesGTFS doit survivre aux identifiants.
+class IdentifiantsGTFS
+{
+public:
+
+    explicit IdentifiantsGTFS(const DonneesGTFS &p_gtfs);
+
+    uint32_t getNbStations() const;
+    uint32_t getNbVoyages() const;
+    uint32_t getNbLignes() const;
+    uint32_t getNbNumerosLigne() const;
+
+    uint32_t indiceStation(const std::string &p_stationId) const;
+    uint32_t indiceVoyage(const std::string &p_voyageId) const;
+    uint32_t indiceLigne(const std::string &p_ligneId) const;
+    bool chercherVoyage(const std::string &p_voyageId, uint32_t &p_voyage) const;
+
+    const std::string &idStation(uint32_t p_station) const;
+    const Station &station(uint32_t p_station) const;
+    const Voyage &voyage(uint32_t p_voyage) const;
+    const Ligne &ligne(uint32_t p_ligne) const;
+    const std::string &numeroLigne(uint32_t p_numero) const;
+
+    uint32_t ligneDuVoyage(uint32_t p_voyage) const;
+    uint32_t numeroDuVoyage(uint32_t p_voyage) const;
+    bool estStationDeTransfert(uint32_t p_station) const;
+    const std::vector<TransfertIndexe> &getTransferts() const;
+
+private:
+
+    std::vector<const std::string *> m_idsStations;
+    std::vector<const Station *> m_stations;
+    std::vector<const Voyage *> m_voyages;
+    std::vector<const Ligne *> m_lignes;
+    std::vector<std::string> m_numerosLigne;
+
+    std::unordered_map<std::string, uint32_t> m_indiceStation;
+    std::unordered_map<std::string, uint32_t> m_indiceVoyage;
+    std::unordered_map<std::string, uint32_t> m_indiceLigne;
+
+    std::vector<uint32_t> m_ligneDuVoyage;
+    std::vector<uint32_t> m_numeroDuVoyage;
+    std::vector<uint8_t> m_estStationDeTransfert;
+    std::vector<TransfertIndexe> m_transferts; /*!< dans l'ordre de DonneesGTFS::getTransferts() */
+};
+
+#endif //IDENTIFIANTSGTFS_H
@@ -0,0 +1,143 @@
+//
+//  IndexSpatial.cpp
+//  Grille uniforme sur les coordonnées des stations pour les recherches de stations à distance de marche
+//
+
+#include "indexSpatial.h"
+#include "empreinteMemoire.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+//! \brief construit la grille des stations
+//! \param[in] p_stations: les stations à indexer (habituellement DonneesGTFS::getStations())
+//! \param[in] p_tailleCellule: la taille visée d'une cellule en km
+//! \throws logic_error si p_tailleCellule n'est pas positive
+IndexSpatial::IndexSpatial(const map<string, Station> &p_stations, double p_tailleCellule)
+        : m_latMin(0), m_lonMin(0), m_pasLat(1), m_pasLon(1), m_nbLignes(0), m_nbColonnes(0)
+{
+    if (!(p_tailleCellule > 0))
+        throw logic_error("IndexSpatial::IndexSpatial(): la taille des cellules doit être positive");
+    if (p_stations.empty()) return;
+
+    double latMax = -90, lonMax = -180;
+    m_latMin = 90;
+    m_lonMin = 180;
+    for (const auto &station : p_stations)
+    {
+        m_stations.push_back(&station.second);
+        m_latMin = min(m_latMin, station.second.getCoords().getLatitude());
+        m_lonMin = min(m_lonMin, station.second.getCoords().getLongitude());
+        latMax = max(latMax, station.second.getCoords().getLatitude());
+        lonMax = max(lonMax, station.second.getCoords().getLongitude());
+    }
+
+    double cosLat = max(cos((m_latMin + latMax) / 2 * degreEnRadian), 0.01);
+    m_pasLat = p_tailleCellule / kmParDegre;
+    m_pasLon = p_tailleCellule / (kmParDegre * cosLat);
+    //on limite le nombre de cellules à quelques-unes par station lorsque le territoire est très étendu
+    while ((latMax - m_latMin) / m_pasLat * (lonMax - m_lonMin) / m_pasLon > 4.0 * m_stations.size())
+    {
+        m_pasLat *= 2;
+        m_pasLon *= 2;
+    }
+    m_nbLignes = static_cast<size_t>((latMax - m_latMin) / m_pasLat) + 1;
+    m_nbColonnes = static_cast<size_t>((lonMax - m_lonMin) / m_pasLon) + 1;
+
+    vector<size_t> celluleDeStation(m_stations.size());
+    m_debutCellules.assign(m_nbLignes * m_nbColonnes + 1, 0);
+    for (size_t s = 0; s < m_stations.size(); ++s)
+    {
+        const Coordonnees &coords = m_stations[s]->getCoords();
+        celluleDeStation[s] = cellule(static_cast<size_t>((coords.getLatitude() - m_latMin) / m_pasLat),
+                                      static_cast<size_t>((coords.getLongitude() - m_lonMin) / m_pasLon));
+        ++m_debutCellules[celluleDeStation[s] + 1];
+    }
+    for (size_t c = 0; c + 1 < m_debutCellules.size(); ++c)
+        m_debutCellules[c + 1] += m_debutCellules[c];
+
+    //les stations d'une cellule restent dans l'ordre de p_stations
+    vector<uint32_t> prochain(m_debutCellules.begin(), m_debutCellules.end() - 1);
+    m_stationsParCellule.resize(m_stations.size());
+    for (size_t s = 0; s < m_stations.size(); ++s)
+        m_stationsParCellule[prochain[celluleDeStation[s]]++] = static_cast<uint32_t>(s);
+}
+
+size_t IndexSpatial::getNbStations() const
+{
+    return m_stations.size();
+}
+
+void IndexSpatial::evaluerMemoire(RapportMemoire &p_rapport, const string &p_nom) const
+{
+    PosteMemoire &poste = p_rapport.ajouter(p_nom);
+    poste.elements = m_stations.size();
+    RapportMemoire::compter(poste, m_stations);
+    RapportMemoire::compter(poste, m_debutCellules);
+    RapportMemoire::compter(poste, m_stationsParCellule);
+}
+
+size_t IndexSpatial::cellule(size_t p_ligne, size_t p_colonne) const
+{
+    return min(p_ligne, m_nbLignes - 1) * m_nbColonnes + min(p_colonne, m_nbColonnes - 1);
+}
+
+//! \brief trouve les stations situées à au plus p_distanceMax km d'un point
+//! \param[in] p_point: les coordonnées GPS du point
+//! \param[in] p_distanceMax: la distance maximale en km
+//! \param[out] p_resultat: les paires (station, distance) dans l'ordre de DonneesGTFS::getStations()
+//! \post le résultat est identique à un parcours complet des stations avec Coordonnees::operator-
+void IndexSpatial::stationsProches(const Coordonnees &p_point, double p_distanceMax,
+                                   vector<pair<const Station *, double> > &p_resultat) const
+{
+    vector<pair<uint32_t, double> > indices;
+    indicesStationsProches(p_point, p_distanceMax, indices);
+    p_resultat.clear();
+    for (const auto &indice : indices)
+        p_resultat.emplace_back(m_stations[indice.first], indice.second);
+}
+
+//! \brief comme stationsProches(), mais retourne l'indice de la station dans l'ordre de DonneesGTFS::getStations()
+void IndexSpatial::indicesStationsProches(const Coordonnees &p_point, double p_distanceMax,
+                                          vector<pair<uint32_t, double> > &p_resultat) const
+{
+    p_resultat.clear();
+    if (m_stations.empty() || p_distanceMax < 0) return;
+
+    const double deltaLat = p_distanceMax / kmParDegre;
+    const double latBasse = p_point.getLatitude() - deltaLat;
+    const double latHaute = p_point.getLatitude() + deltaLat;
+    const double cosLat = cos(min(max(fabs(latBasse), fabs(latHaute)), 90.0) * degreEnRadian);
+    const double deltaLon = cosLat > 1e-6 ? p_distanceMax / (kmParDegre * cosLat) : 360.0;
+
+    auto borne = [](double p_valeur, double p_min, double p_pas, size_t p_nb) -> long
+    {
+        double indice = floor((p_valeur - p_min) / p_pas);
+        return static_cast<long>(min(max(indice, -1.0), static_cast<double>(p_nb)));
+    };
+    long ligneMin = max(borne(latBasse, m_latMin, m_pasLat, m_nbLignes), 0L);
+    long ligneMax = min(borne(latHaute, m_latMin, m_pasLat, m_nbLignes), static_cast<long>(m_nbLignes) - 1);
+    long colonneMin = max(borne(p_point.getLongitude() - deltaLon, m_lonMin, m_pasLon, m_nbColonnes), 0L);
+    long colonneMax = min(borne(p_point.getLongitude() + deltaLon, m_lonMin, m_pasLon, m_nbColonnes),
+                          static_cast<long>(m_nbColonnes) - 1);
+
+    vector<uint32_t> candidats;
+    for (long ligne = ligneMin; ligne <= ligneMax; ++ligne)
+    {
+        for (long colonne = colonneMin; colonne <= colonneMax; ++colonne)
+        {
+            size_t c = cellule(ligne, colonne);
+            candidats.insert(candidats.end(), m_stationsParCellule.begin() + m_debutCellules[c],
+                             m_stationsParCellule.begin() + m_debutCellules[c + 1]);
+        }
+    }
+    sort(candidats.begin(), candidats.end());
+
+    for (uint32_t s : candidats)
+    {
+        double distance = p_point - m_stations[s]->getCoords();
+        if (distance <= p_distanceMax)
+            p_resultat.emplace_back(s, distance);
+    }
+}
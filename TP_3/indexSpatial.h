@@ -0,0 +1,54 @@
+//
+//  IndexSpatial.h
+//  Grille uniforme sur les coordonnées des stations pour les recherches de stations à distance de marche
+//
+
+#ifndef INDEXSPATIAL_H
+#define INDEXSPATIAL_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "DonneesGTFS.h"
+
+class RapportMemoire;
+
+//! \brief  Index spatial (grille uniforme en latitude/longitude) des stations d'un objet DonneesGTFS
+//! \brief  Construit une seule fois; les stations indexées doivent survivre à l'index.
+class IndexSpatial
+{
+public:
+
+    explicit IndexSpatial(const std::map<std::string, Station> &p_stations, double p_tailleCellule = 1.0);
+
+    void stationsProches(const Coordonnees &p_point, double p_distanceMax,
+                         std::vector<std::pair<const Station *, double> > &p_resultat) const;
+    void indicesStationsProches(const Coordonnees &p_point, double p_distanceMax,
+                                std::vector<std::pair<uint32_t, double> > &p_resultat) const;
+    size_t getNbStations() const;
+    void evaluerMemoire(RapportMemoire &p_rapport, const std::string &p_nom) const;
+
+    //! \brief borne inférieure du nombre de km par degré de latitude (Coordonnees::operator- utilise la formule de
+    //! \brief haversine); sert aussi aux grilles de CacheItineraires
+    static constexpr double kmParDegre = 111.0;
+    static constexpr double degreEnRadian = 3.14159265358979323846 / 180.0;
+
+    //! \brief règles de marche communes aux réseaux et aux moteurs qui cherchent les stations proches d'un point
+    static constexpr double vitesseDeMarche = 5.0;   /*!< vitesse de marche en km/h */
+    static constexpr double distanceMaxMarche = 1.0; /*!< distance maximale de marche en km */
+
+private:
+
+    size_t cellule(size_t p_ligne, size_t p_colonne) const;
+
+    std::vector<const Station *> m_stations;  /*!< stations dans l'ordre de DonneesGTFS::getStations() */
+    std::vector<uint32_t> m_debutCellules;    /*!< les stations de la cellule c sont [m_debutCellules[c], m_debutCellules[c+1]) */
+    std::vector<uint32_t> m_stationsParCellule;
+    double m_latMin, m_lonMin;
+    double m_pasLat, m_pasLon;                /*!< dimensions d'une cellule en degrés */
+    size_t m_nbLignes, m_nbColonnes;
+};
+
+#endif //INDEXSPATIAL_H
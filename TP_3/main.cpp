@@ -6,12 +6,31 @@
 #include <random>
 
 #include "DonneesGTFS.h"
-#include "ReseauGTFS.h"
+#include "reseauPartage.h"
+#include "empreinteMemoire.h"
+#include "instantaneArrets.h"
 
 using namespace std;
 
-int main()
+//! \brief l'option --memoire affiche la mémoire occupée par les données et le réseau après leur construction
+//! \brief l'option --instantane <répertoire> relit les arrêts et le réseau des instantanés arrets.bin et reseau.bin de
+//! \brief ce répertoire s'ils correspondent aux fichiers GTFS, sinon les reconstruit et les y écrit; sans elle, aucun
+//! \brief instantané n'est lu ni écrit
+int main(int argc, char *argv[])
 {
+    bool afficherMemoire = false;
+    std::string repertoireInstantanes; //vide: pas d'instantané
+    for (int i = 1; i < argc; ++i)
+    {
+        const string option = argv[i];
+        if (option == "--memoire") afficherMemoire = true;
+        else if (option == "--instantane" && i + 1 < argc) repertoireInstantanes = argv[++i];
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--memoire] [--instantane <répertoire>]" << endl;
+            return 1;
+        }
+    }
     const std::string chemin_dossier = "RTC-1aout-25nov";
     Date today(2022, 8, 3);
     Heure now1(7, 30, 0);
@@ -30,20 +49,37 @@ int main()
     cout << "Nombre de services = " << nb_services << endl;
     if (nb_services == 0) throw logic_error("main(): On doit avoir nb_services > 0 pour continuer");
     donnees_rtc.ajouterVoyagesDeLaDate(chemin_dossier + "/trips.txt");
-    donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    bool arretsRelus = false;
+    if (repertoireInstantanes.empty())
+        donnees_rtc.ajouterArretsDesVoyagesDeLaDate(chemin_dossier + "/stop_times.txt");
+    else
+        arretsRelus = InstantaneArrets::ajouterArrets(donnees_rtc, chemin_dossier, repertoireInstantanes + "/arrets.bin");
     donnees_rtc.ajouterTransferts(chemin_dossier + "/transfers.txt");
     clock_t end = clock();
-    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl;
+    cout << "Chargement des données effectué en " << double(end - begin) / CLOCKS_PER_SEC << " secondes"
+         << (arretsRelus ? " (arrêts relus de l'instantané)" : "") << endl;
     cout << "Nombre de stations ayant au moins 1 arrêt = " << donnees_rtc.getNbStations() << endl;
     cout << "Nombre de transferts = " << donnees_rtc.getNbTransferts() << endl;
     cout << "Nombres de voyages = " << donnees_rtc.getNbVoyages() << endl;
     cout << "Nombre d'arrêts = " << donnees_rtc.getNbArrets() << endl;
     begin = clock();
-    ReseauGTFS reseau_rtc(donnees_rtc);
+    //avec les instantanés, seuls les petits fichiers GTFS sont encore lus en texte (DonneesGTFS reste nécessaire pour
+    //les stations et l'affichage des itinéraires)
+    ReseauPartage reseau_rtc = repertoireInstantanes.empty() ?
+                               ReseauPartage(donnees_rtc) :
+                               ReseauPartage(donnees_rtc, chemin_dossier, repertoireInstantanes + "/reseau.bin");
     end = clock();
     cout << "Le nombre d'arcs (sans le point origine et destination) est = " << reseau_rtc.getNbArcs() << endl;
-    cout << "Graphe (sans le point source et destination) a été produit en " << double(end - begin) / CLOCKS_PER_SEC
-         << " secondes" << endl << endl;
+    cout << "Graphe (sans le point source et destination) a été " << (reseau_rtc.estChargeDeInstantane() ? "relu" : "produit")
+         << " en " << double(end - begin) / CLOCKS_PER_SEC << " secondes" << endl << endl;
+    if (afficherMemoire)
+    {
+        RapportMemoire rapport;
+        rapport.ajouterDonnees(donnees_rtc);
+        reseau_rtc.evaluerMemoire(rapport);
+        rapport.afficher(cout);
+        cout << endl;
+    }
 
     cout << "==========================================" << endl;
     cout << "           début de la simulation         " << endl;
@@ -65,6 +101,7 @@ int main()
         distribution(generator);
     }
 
+    ContexteItineraire contexte; //espace de travail des requêtes; le réseau n'est jamais modifié
     bool afficherItineraire = true;
     const unsigned int nbDeTests = 10; //nombre de tests à effectuer
     long moy_tempsExecution = 0;
@@ -92,10 +129,9 @@ int main()
         cout << "station du point destination = " << stations.at(stationIdDestination) << endl;
         cout << "distance = " << pointOrigine - pointDestination << " kilomètres" << endl;
 
-        reseau_rtc.ajouterArcsOrigineDestination(donnees_rtc, pointOrigine, pointDestination);
-
         long tempsExecution(0);
-        unsigned int tempsDuTrajet = reseau_rtc.itineraire(donnees_rtc, afficherItineraire, tempsExecution);
+        unsigned int tempsDuTrajet = reseau_rtc.itineraire(donnees_rtc, pointOrigine, pointDestination,
+                                                           afficherItineraire, tempsExecution, contexte);
         if (tempsDuTrajet == numeric_limits<unsigned int>::max())
         {
             cout << "impossible d'atteindre la destination. On passe au test suivant." << endl;
@@ -110,9 +146,10 @@ int main()
             ++nbDeTestsComptabilises;
             cout << "Temps d'exécution de l'algorithme de plus court chemin: " << tempsExecution
                  << " microsecondes" << endl;
+            if (statistiquesRechercheActives)
+                cout << "Effort de la recherche: " << contexte.statistiques << endl;
 
         }
-        reseau_rtc.enleverArcsOrigineDestination();
 
     }
 
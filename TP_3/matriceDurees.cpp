@@ -0,0 +1,54 @@
+//
+//  MatriceDurees.cpp
+//  Matrice origine-destination des durées de trajet et son écriture en CSV ou en binaire
+//
+
+#include "matriceDurees.h"
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+    const char magieMatrice[8] = {'M', 'A', 'T', 'R', 'I', 'C', 'E', '1'};
+}
+
+//! \brief écrit une ligne d'en-tête (indices des destinations) puis une ligne par origine débutant par son indice
+//! \brief une destination inatteignable donne un champ vide
+//! \throws logic_error si l'écriture échoue
+void MatriceDurees::ecrireCSV(ostream &p_flux) const
+{
+    p_flux << "origine";
+    for (uint32_t d = 0; d < nbDestinations; ++d) p_flux << ',' << d;
+    p_flux << '\n';
+    for (uint32_t o = 0; o < nbOrigines; ++o)
+    {
+        p_flux << o;
+        for (uint32_t d = 0; d < nbDestinations; ++d)
+        {
+            p_flux << ',';
+            if (duree(o, d) != numeric_limits<unsigned int>::max()) p_flux << duree(o, d);
+        }
+        p_flux << '\n';
+    }
+    if (!p_flux) throw logic_error("MatriceDurees::ecrireCSV(): échec de l'écriture");
+}
+
+//! \brief format (ordre des octets de la machine): "MATRICE1", nbOrigines et nbDestinations sur 32 bits, puis les
+//! \brief durées sur 32 bits rangées par origine (0xFFFFFFFF si inatteignable)
+//! \throws logic_error si l'écriture échoue
+void MatriceDurees::ecrireBinaire(ostream &p_flux) const
+{
+    p_flux.write(magieMatrice, sizeof(magieMatrice));
+    p_flux.write(reinterpret_cast<const char *>(&nbOrigines), sizeof(nbOrigines));
+    p_flux.write(reinterpret_cast<const char *>(&nbDestinations), sizeof(nbDestinations));
+    vector<uint32_t> ligne(nbDestinations);
+    for (uint32_t o = 0; o < nbOrigines; ++o)
+    {
+        for (uint32_t d = 0; d < nbDestinations; ++d) ligne[d] = static_cast<uint32_t>(duree(o, d));
+        p_flux.write(reinterpret_cast<const char *>(ligne.data()),
+                     static_cast<streamsize>(ligne.size() * sizeof(uint32_t)));
+    }
+    if (!p_flux) throw logic_error("MatriceDurees::ecrireBinaire(): échec de l'écriture");
+}
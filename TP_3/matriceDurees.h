@@ -0,0 +1,30 @@
+//
+//  MatriceDurees.h
+//  Matrice origine-destination des durées de trajet et son écriture en CSV ou en binaire
+//
+
+#ifndef MATRICEDUREES_H
+#define MATRICEDUREES_H
+
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+//! \brief Durées de trajet en secondes, rangées par origine: duree(o, d) = durees[o * nbDestinations + d]
+//! \brief numeric_limits<unsigned int>::max() indique une destination inatteignable
+struct MatriceDurees
+{
+    uint32_t nbOrigines = 0;
+    uint32_t nbDestinations = 0;
+    std::vector<unsigned int> durees;
+
+    unsigned int duree(size_t p_origine, size_t p_destination) const
+    {
+        return durees[p_origine * nbDestinations + p_destination];
+    }
+
+    void ecrireCSV(std::ostream &p_flux) const;
+    void ecrireBinaire(std::ostream &p_flux) const;
+};
+
+#endif //MATRICEDUREES_H
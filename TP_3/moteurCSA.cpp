@@ -0,0 +1,561 @@
+//
+//  MoteurCSA.cpp
+//  Calcul d'itinéraires par l'algorithme Connection Scan (CSA) directement sur les arrêts de DonneesGTFS
+//
+
+#include "moteurCSA.h"
+#include <algorithm>
+#include <queue>
+#include <functional>
+#include <sys/time.h>
+
+using namespace std;
+
+namespace
+{
+    const uint32_t AUCUNE = numeric_limits<uint32_t>::max();
+
+    uint32_t secondes(const Heure &p_heure)
+    {
+        return static_cast<uint32_t>(p_heure - Heure(0, 0, 0));
+    }
+
+    //! \brief heure d'arrivée à destination au plus tôt en montant à bord à partir de l'heure p_heure
+    //! \return AUCUNE si aucun départ du profil n'a lieu à p_heure ou plus tard
+    uint32_t arriveeDuProfil(const vector<pair<uint32_t, uint32_t> > &p_profil, uint32_t p_heure)
+    {
+        if (p_heure == AUCUNE) return AUCUNE;
+        //les départs >= p_heure forment un préfixe; le dernier a la meilleure arrivée
+        auto fin = partition_point(p_profil.begin(), p_profil.end(),
+                                   [p_heure](const pair<uint32_t, uint32_t> &e) { return e.first >= p_heure; });
+        return fin == p_profil.begin() ? AUCUNE : prev(fin)->second;
+    }
+
+    uint32_t ajouter(uint32_t p_heure, uint32_t p_duree)
+    {
+        return p_heure == AUCUNE || p_duree == AUCUNE ? AUCUNE : p_heure + p_duree;
+    }
+}
+
+//! \brief construit le moteur avec ses propres identifiants (voir le constructeur suivant)
+MoteurCSA::MoteurCSA(const DonneesGTFS &p_gtfs)
+        : MoteurCSA(p_gtfs, IdentifiantsGTFS(p_gtfs))
+{
+}
+
+//! \brief construit le tableau des connexions triées et les trajets à pieds entre stations
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_identifiants: les identifiants de p_gtfs; ils peuvent être détruits après la construction
+MoteurCSA::MoteurCSA(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants)
+        : m_indexStations(p_gtfs.getStations())
+{
+    for (uint32_t s = 0; s < p_identifiants.getNbStations(); ++s)
+        m_stations.push_back(&p_identifiants.station(s));
+
+    m_connexions.reserve(p_gtfs.getNbArrets());
+    for (uint32_t v = 0; v < p_identifiants.getNbVoyages(); ++v)
+    {
+        m_voyages.push_back(&p_identifiants.voyage(v));
+        const Arret *precedent = nullptr;
+        uint32_t stationPrecedente = 0;
+        for (const auto &arret : p_identifiants.voyage(v).getArrets())
+        {
+            const uint32_t station = p_identifiants.indiceStation(arret->getStationId());
+            if (precedent)
+            {
+                m_connexions.push_back({secondes(precedent->getHeureDepart()), secondes(arret->getHeureArrivee()),
+                                        stationPrecedente, station, v});
+            }
+            precedent = arret.get();
+            stationPrecedente = station;
+        }
+    }
+    //à heure de départ égale, l'ordre des arrêts d'un voyage est conservé (connexions de durée nulle)
+    stable_sort(m_connexions.begin(), m_connexions.end(),
+                [](const Connexion &a, const Connexion &b) { return a.heureDepart < b.heureDepart; });
+
+    construireTransferts(p_identifiants, m_debutTransferts, m_transferts, m_delaiCorrespondance);
+}
+
+size_t MoteurCSA::getNbConnexions() const
+{
+    return m_connexions.size();
+}
+
+//! \brief construit les trajets à pieds entre stations à partir des transferts de DonneesGTFS
+//! \brief un transfert d'une station vers elle-même donne son délai de correspondance (delaiMinCorrespondance sinon)
+//! \param[in] p_identifiants: les transferts, déjà traduits en indices de station
+//! \param[out] p_debutTransferts, p_transferts: les transferts de la station s sont
+//! \param[out] [p_debutTransferts[s], p_debutTransferts[s+1]) de p_transferts
+//! \param[out] p_delaiCorrespondance: le délai pour changer de véhicule à chaque station
+void MoteurCSA::construireTransferts(const IdentifiantsGTFS &p_identifiants, vector<uint32_t> &p_debutTransferts,
+                                     vector<Transfert> &p_transferts,
+                                     vector<uint32_t> &p_delaiCorrespondance)
+{
+    const uint32_t nbStations = p_identifiants.getNbStations();
+    p_delaiCorrespondance.assign(nbStations, delaiMinCorrespondance);
+    p_transferts.clear();
+    vector<vector<Transfert> > transfertsParStation(nbStations);
+    for (const auto &transfert : p_identifiants.getTransferts())
+    {
+        if (transfert.stationDepart == transfert.stationArrivee)
+            p_delaiCorrespondance[transfert.stationDepart] = transfert.duree;
+        else
+            transfertsParStation[transfert.stationDepart].push_back({transfert.stationArrivee, transfert.duree});
+    }
+    //fermeture transitive: une marche peut enchaîner plusieurs transferts (comme dans le graphe), on garde pour
+    //chaque paire de stations la durée de marche la plus courte; le balayage n'a alors jamais à enchaîner de transferts
+    vector<uint32_t> duree(nbStations, AUCUNE);
+    vector<uint32_t> atteintes;
+    priority_queue<pair<uint32_t, uint32_t>, vector<pair<uint32_t, uint32_t> >, greater<pair<uint32_t, uint32_t> > > file;
+    p_debutTransferts.assign(1, 0);
+    for (uint32_t a = 0; a < nbStations; ++a)
+    {
+        if (!transfertsParStation[a].empty())
+        {
+            duree[a] = 0;
+            atteintes.push_back(a);
+            file.push({0, a});
+        }
+        while (!file.empty())
+        {
+            const pair<uint32_t, uint32_t> courant = file.top();
+            file.pop();
+            if (courant.first > duree[courant.second]) continue;
+            for (const auto &transfert : transfertsParStation[courant.second])
+            {
+                const uint32_t total = courant.first + transfert.duree;
+                if (total >= duree[transfert.station]) continue;
+                if (duree[transfert.station] == AUCUNE) atteintes.push_back(transfert.station);
+                duree[transfert.station] = total;
+                file.push({total, transfert.station});
+            }
+        }
+        for (uint32_t b : atteintes)
+        {
+            if (b != a) p_transferts.push_back({b, duree[b]});
+            duree[b] = AUCUNE;
+        }
+        atteintes.clear();
+        p_debutTransferts.push_back(static_cast<uint32_t>(p_transferts.size()));
+    }
+}
+
+//! \brief place les stations accessibles à pieds depuis le point origine à p_heureDebut, directement ou par un
+//! \brief transfert depuis une station proche du point origine, sans avoir pris de véhicule
+//! \brief les tableaux pret, aPieds et stationMarche du contexte doivent avoir été réinitialisés
+void MoteurCSA::marcherDepuisOrigine(const Coordonnees &p_pointOrigine, uint32_t p_heureDebut,
+                                     ContexteCSA &p_contexte) const
+{
+    m_indexStations.indicesStationsProches(p_pointOrigine, IndexSpatial::distanceMaxMarche, p_contexte.stationsProches);
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        const uint32_t heure = p_heureDebut + static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+        if (heure < p_contexte.pret[station.first])
+        {
+            p_contexte.pret[station.first] = heure;
+            p_contexte.stationMarche[station.first] = station.first;
+            p_contexte.aPieds[station.first] = 0;
+        }
+    }
+    //les transferts étant fermés transitivement, un seul transfert depuis chaque station proche suffit
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        const uint32_t s = station.first;
+        if (p_contexte.stationMarche[s] != s) continue;
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+        {
+            const Transfert &transfert = m_transferts[t];
+            if (p_contexte.pret[s] + transfert.duree < p_contexte.pret[transfert.station])
+            {
+                p_contexte.pret[transfert.station] = p_contexte.pret[s] + transfert.duree;
+                p_contexte.stationMarche[transfert.station] = s;
+                p_contexte.aPieds[transfert.station] = 1;
+            }
+        }
+    }
+}
+
+//! \brief réinitialise le contexte et place les stations accessibles à pieds depuis le point origine
+//! \return l'heure d'arrivée au point destination en marchant sans prendre de véhicule (en passant par une station
+//! \return proche des deux points, comme dans le graphe), ou AUCUNE
+uint32_t MoteurCSA::preparer(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                             uint32_t p_heureDebut, ContexteCSA &p_contexte) const
+{
+    const size_t nbStations = m_stations.size();
+    p_contexte.pret.assign(nbStations, AUCUNE);
+    p_contexte.parentMontee.assign(nbStations, AUCUNE);
+    p_contexte.parentDescente.assign(nbStations, AUCUNE);
+    p_contexte.aPieds.assign(nbStations, 0);
+    p_contexte.stationMarche.assign(nbStations, AUCUNE);
+    p_contexte.marcheVersDestination.assign(nbStations, AUCUNE);
+    p_contexte.monteeVoyage.assign(m_voyages.size(), AUCUNE);
+    p_contexte.monteeFinale = AUCUNE;
+    p_contexte.descenteFinale = AUCUNE;
+    p_contexte.stationFinale = AUCUNE;
+
+    marcherDepuisOrigine(p_pointOrigine, p_heureDebut, p_contexte);
+
+    uint32_t meilleureArrivee = AUCUNE;
+    m_indexStations.indicesStationsProches(p_pointDestination, IndexSpatial::distanceMaxMarche,
+                                           p_contexte.stationsProches);
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        const uint32_t marche = static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+        p_contexte.marcheVersDestination[station.first] = marche;
+        if (p_contexte.stationMarche[station.first] != AUCUNE && p_contexte.pret[station.first] + marche < meilleureArrivee)
+        {
+            meilleureArrivee = p_contexte.pret[station.first] + marche;
+            p_contexte.stationFinale = station.first;
+        }
+    }
+    return meilleureArrivee;
+}
+
+//! \brief calcule l'itinéraire arrivant au plus tôt au point destination en partant à DonneesGTFS::getTempsDebut()
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le moteur
+//! \param[in] p_afficherItineraire: l'itinéraire est affiché lorsque true (même format que ReseauGTFS::itineraire)
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche en microsecondes
+//! \param[in,out] p_contexte: l'espace de travail du fil d'exécution appelant
+//! \return la durée du trajet en secondes (= numeric_limits<unsigned int>::max() si la destination est inatteignable)
+unsigned int MoteurCSA::itineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                   const Coordonnees &p_pointDestination, bool p_afficherItineraire,
+                                   long &p_tempsExecution, ContexteCSA &p_contexte) const
+{
+    timeval debut, fin;
+    gettimeofday(&debut, nullptr);
+
+    const uint32_t heureDebut = secondes(p_gtfs.getTempsDebut());
+    uint32_t meilleureArrivee = preparer(p_pointOrigine, p_pointDestination, heureDebut, p_contexte);
+    auto premiere = lower_bound(m_connexions.begin(), m_connexions.end(), heureDebut,
+                                [](const Connexion &c, uint32_t h) { return c.heureDepart < h; });
+    for (auto c = premiere; c != m_connexions.end() && c->heureDepart < meilleureArrivee; ++c)
+    {
+        const uint32_t indice = static_cast<uint32_t>(c - m_connexions.begin());
+        uint32_t &montee = p_contexte.monteeVoyage[c->voyage];
+        if (montee == AUCUNE)
+        {
+            if (p_contexte.pret[c->stationDepart] > c->heureDepart) continue;
+            montee = indice;
+        }
+
+        const uint32_t s = c->stationArrivee;
+        if (p_contexte.marcheVersDestination[s] != AUCUNE &&
+            c->heureArrivee + p_contexte.marcheVersDestination[s] < meilleureArrivee)
+        {
+            meilleureArrivee = c->heureArrivee + p_contexte.marcheVersDestination[s];
+            p_contexte.monteeFinale = montee;
+            p_contexte.descenteFinale = indice;
+            p_contexte.stationFinale = s;
+        }
+        if (c->heureArrivee + m_delaiCorrespondance[s] < p_contexte.pret[s])
+        {
+            p_contexte.pret[s] = c->heureArrivee + m_delaiCorrespondance[s];
+            p_contexte.parentMontee[s] = montee;
+            p_contexte.parentDescente[s] = indice;
+            p_contexte.aPieds[s] = 0;
+            p_contexte.stationMarche[s] = AUCUNE;
+        }
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+        {
+            const Transfert &transfert = m_transferts[t];
+            const uint32_t marche = p_contexte.marcheVersDestination[transfert.station];
+            if (marche != AUCUNE && c->heureArrivee + transfert.duree + marche < meilleureArrivee)
+            {
+                meilleureArrivee = c->heureArrivee + transfert.duree + marche;
+                p_contexte.monteeFinale = montee;
+                p_contexte.descenteFinale = indice;
+                p_contexte.stationFinale = transfert.station;
+            }
+            if (c->heureArrivee + transfert.duree < p_contexte.pret[transfert.station])
+            {
+                p_contexte.pret[transfert.station] = c->heureArrivee + transfert.duree;
+                p_contexte.parentMontee[transfert.station] = montee;
+                p_contexte.parentDescente[transfert.station] = indice;
+                p_contexte.aPieds[transfert.station] = 1;
+                p_contexte.stationMarche[transfert.station] = AUCUNE;
+            }
+        }
+    }
+
+    gettimeofday(&fin, nullptr);
+    p_tempsExecution = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+
+    if (meilleureArrivee == AUCUNE) return numeric_limits<unsigned int>::max();
+    if (p_afficherItineraire)
+        afficherItineraire(p_gtfs, heureDebut, meilleureArrivee - heureDebut, p_contexte);
+    return meilleureArrivee - heureDebut;
+}
+
+//! \brief affiche l'itinéraire trouvé par la dernière recherche du contexte
+void MoteurCSA::afficherItineraire(const DonneesGTFS &p_gtfs, uint32_t p_heureDebut, uint32_t p_duree,
+                                   const ContexteCSA &p_contexte) const
+{
+    //on remonte les trajets (montée, descente) depuis la fin de l'itinéraire
+    vector<pair<uint32_t, uint32_t> > trajets;
+    for (uint32_t montee = p_contexte.monteeFinale, descente = p_contexte.descenteFinale; montee != AUCUNE;)
+    {
+        trajets.emplace_back(montee, descente);
+        const uint32_t station = m_connexions[montee].stationDepart;
+        montee = p_contexte.parentMontee[station];
+        descente = p_contexte.parentDescente[station];
+    }
+    reverse(trajets.begin(), trajets.end());
+
+    const Heure minuit(0, 0, 0);
+    cout << endl << "=====================" << endl;
+    cout << "     ITINÉRAIRE      " << endl;
+    cout << "=====================" << endl << endl;
+    cout << "Heure de départ du point d'origine: " << minuit.add_secondes(p_heureDebut) << endl;
+    //première station: celle où l'on monte à bord, ou celle où l'on marche à la destination si aucun véhicule n'est pris
+    const uint32_t premiereStation = trajets.empty() ? p_contexte.stationFinale
+                                                     : m_connexions[trajets.front().first].stationDepart;
+    const uint32_t stationProche = p_contexte.stationMarche[premiereStation] == AUCUNE
+                                   ? premiereStation : p_contexte.stationMarche[premiereStation];
+    cout << "Rendez vous à la station " << *m_stations[stationProche] << endl;
+    if (stationProche != premiereStation)
+    {
+        cout << "De cette station, rendez-vous à pieds à la station " << *m_stations[premiereStation] << endl;
+    }
+    for (size_t k = 0; k < trajets.size(); ++k)
+    {
+        const Connexion &montee = m_connexions[trajets[k].first];
+        const Connexion &descente = m_connexions[trajets[k].second];
+        const Voyage &voyage = *m_voyages[montee.voyage];
+        if (k > 0 && montee.stationDepart != m_connexions[trajets[k - 1].second].stationArrivee)
+        {
+            cout << "De cette station, rendez-vous à pieds à la station " << *m_stations[montee.stationDepart] << endl;
+        }
+        cout << "De cette station, prenez l'autobus numéro " << p_gtfs.getLignes().at(voyage.getLigne()).getNumero()
+             << " à l'heure " << minuit.add_secondes(montee.heureDepart) << " Vers " << voyage.getDestination() << endl;
+        cout << "et arrêtez-vous à la station " << *m_stations[descente.stationArrivee] << " à l'heure "
+             << minuit.add_secondes(descente.heureArrivee) << endl;
+    }
+    if (!trajets.empty() && m_connexions[trajets.back().second].stationArrivee != p_contexte.stationFinale)
+    {
+        cout << "De cette station, rendez-vous à pieds à la station " << *m_stations[p_contexte.stationFinale] << endl;
+    }
+    cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
+    cout << "Heure d'arrivée à la destination: " << minuit.add_secondes(p_heureDebut + p_duree) << endl;
+    cout << "Durée du trajet: " << p_duree / 3600 << " heures, " << p_duree % 3600 / 60 << " minutes, "
+         << p_duree % 60 << " secondes" << endl;
+}
+
+//! \brief calcule en un seul balayage tous les trajets Pareto-optimaux (départ au plus tard, arrivée au plus tôt)
+//! \brief partant du point origine entre p_debut et p_fin, selon les règles de marche et de correspondance de
+//! \brief itineraire(): partir du point origine à p_trajets[i].depart fait arriver à p_trajets[i].arrivee, et la
+//! \brief durée que donnerait itineraire() pour un départ à h est celle du premier trajet dont le départ est >= h.
+//! \brief (Les trajets partant après p_fin ne sont pas retenus: près de p_fin, le meilleur peut en faire partie. Les
+//! \brief trajets entièrement à pieds, dont la durée ne dépend pas de l'heure de départ, non plus.)
+//! \brief Les connexions sont parcourues en ordre décroissant d'heure de départ (Connection Scan de profil):
+//! \brief chaque station garde la fonction "heure de montée -> arrivée à destination" sous forme de paires Pareto.
+//! \param[in] p_debut: le début de l'intervalle des heures de départ du point origine
+//! \param[in] p_fin: la fin (incluse) de l'intervalle des heures de départ
+//! \param[out] p_trajets: les trajets en ordre croissant de départ (et d'arrivée)
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche en microsecondes
+//! \param[in,out] p_contexte: l'espace de travail du fil d'exécution appelant
+void MoteurCSA::profil(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                       const Heure &p_debut, const Heure &p_fin, vector<TrajetProfil> &p_trajets,
+                       long &p_tempsExecution, ContexteProfilCSA &p_contexte) const
+{
+    timeval debut, fin;
+    gettimeofday(&debut, nullptr);
+
+    const uint32_t heureDebut = secondes(p_debut), heureFin = secondes(p_fin);
+    p_trajets.clear();
+    p_contexte.profils.resize(m_stations.size());
+    for (auto &profilStation : p_contexte.profils) profilStation.clear();
+    p_contexte.arriveeVoyage.assign(m_voyages.size(), AUCUNE);
+    p_contexte.marcheVersDestination.assign(m_stations.size(), AUCUNE);
+    m_indexStations.indicesStationsProches(p_pointDestination, IndexSpatial::distanceMaxMarche,
+                                           p_contexte.stationsProches);
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        p_contexte.marcheVersDestination[station.first] =
+                static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+    }
+
+    auto premiere = lower_bound(m_connexions.begin(), m_connexions.end(), heureDebut,
+                                [](const Connexion &c, uint32_t h) { return c.heureDepart < h; });
+    for (auto c = m_connexions.end(); c != premiere;)
+    {
+        --c;
+        //descendre à la station d'arrivée (puis marcher), rester à bord, ou changer de véhicule
+        const uint32_t s = c->stationArrivee;
+        uint32_t arrivee = min(ajouter(c->heureArrivee, p_contexte.marcheVersDestination[s]),
+                               p_contexte.arriveeVoyage[c->voyage]);
+        arrivee = min(arrivee, arriveeDuProfil(p_contexte.profils[s], c->heureArrivee + m_delaiCorrespondance[s]));
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+        {
+            const Transfert &transfert = m_transferts[t];
+            const uint32_t apresMarche = c->heureArrivee + transfert.duree;
+            arrivee = min(arrivee, ajouter(apresMarche, p_contexte.marcheVersDestination[transfert.station]));
+            arrivee = min(arrivee, arriveeDuProfil(p_contexte.profils[transfert.station], apresMarche));
+        }
+        if (arrivee == AUCUNE) continue;
+
+        p_contexte.arriveeVoyage[c->voyage] = min(p_contexte.arriveeVoyage[c->voyage], arrivee);
+        auto &profilDepart = p_contexte.profils[c->stationDepart];
+        if (profilDepart.empty() || arrivee < profilDepart.back().second)
+        {
+            if (!profilDepart.empty() && profilDepart.back().first == c->heureDepart)
+                profilDepart.back().second = arrivee;
+            else
+                profilDepart.emplace_back(c->heureDepart, arrivee);
+        }
+    }
+
+    //trajets partant du point origine: marche vers une station proche, et éventuellement un transfert vers une autre
+    //station, puis montée selon le profil de la station atteinte
+    m_indexStations.indicesStationsProches(p_pointOrigine, IndexSpatial::distanceMaxMarche,
+                                           p_contexte.stationsProches);
+    auto monterA = [&](uint32_t p_station, uint32_t p_marche)
+    {
+        for (const auto &entree : p_contexte.profils[p_station])
+        {
+            if (entree.first < heureDebut + p_marche) break;
+            if (entree.first - p_marche <= heureFin)
+                p_trajets.push_back({entree.first - p_marche, entree.second, p_station});
+        }
+    };
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        const uint32_t marche = static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+        monterA(station.first, marche);
+        for (uint32_t t = m_debutTransferts[station.first]; t < m_debutTransferts[station.first + 1]; ++t)
+            monterA(m_transferts[t].station, marche + m_transferts[t].duree);
+    }
+    //on ne garde que les trajets qu'aucun autre ne domine (départ plus tard, arrivée au moins aussi tôt)
+    sort(p_trajets.begin(), p_trajets.end(), [](const TrajetProfil &a, const TrajetProfil &b)
+    {
+        return a.depart != b.depart ? a.depart > b.depart : a.arrivee < b.arrivee;
+    });
+    size_t nbGardes = 0;
+    for (size_t i = 0; i < p_trajets.size(); ++i)
+    {
+        if (nbGardes == 0 || p_trajets[i].arrivee < p_trajets[nbGardes - 1].arrivee)
+            p_trajets[nbGardes++] = p_trajets[i];
+    }
+    p_trajets.resize(nbGardes);
+    reverse(p_trajets.begin(), p_trajets.end());
+
+    gettimeofday(&fin, nullptr);
+    p_tempsExecution = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+}
+
+//! \brief affiche les trajets d'un profil, un par ligne
+void MoteurCSA::afficherProfil(const vector<TrajetProfil> &p_trajets) const
+{
+    const Heure minuit(0, 0, 0);
+    cout << endl << "=====================" << endl;
+    cout << "       PROFIL        " << endl;
+    cout << "=====================" << endl << endl;
+    for (const auto &trajet : p_trajets)
+    {
+        const uint32_t duree = trajet.arrivee - trajet.depart;
+        cout << "Départ: " << minuit.add_secondes(trajet.depart) << " Arrivée: " << minuit.add_secondes(trajet.arrivee)
+             << " Durée: " << duree / 3600 << " heures, " << duree % 3600 / 60 << " minutes, " << duree % 60
+             << " secondes, à partir de la station " << *m_stations[trajet.stationMontee] << endl;
+    }
+    if (p_trajets.empty()) cout << "Aucun trajet dans cet intervalle" << endl;
+}
+
+//! \brief calcule en un seul balayage l'heure d'arrivée au plus tôt à chaque station en partant du point origine
+//! \brief à p_depart, selon les règles de marche et de correspondance de itineraire(); une station est atteinte à pieds
+//! \brief depuis le point origine (si elle en est assez proche), en descendant d'un véhicule ou par un transfert
+//! \param[in] p_dureeMax: le balayage s'arrête après p_depart + p_dureeMax (numeric_limits<unsigned int>::max()
+//! \param[in] pour tout le réseau); les stations atteintes plus tard sont inatteignables
+//! \param[out] p_arrivees: l'heure d'arrivée en secondes depuis minuit de chaque station, dans l'ordre de
+//! \param[out] DonneesGTFS::getStations() (= inatteignable si la station ne peut être atteinte)
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche en microsecondes
+//! \param[in,out] p_contexte: l'espace de travail du fil d'exécution appelant
+void MoteurCSA::arriveesAuPlusTot(const Coordonnees &p_pointOrigine, const Heure &p_depart, unsigned int p_dureeMax,
+                                  vector<uint32_t> &p_arrivees, long &p_tempsExecution,
+                                  ContexteCSA &p_contexte) const
+{
+    timeval debut, fin;
+    gettimeofday(&debut, nullptr);
+
+    const uint32_t heureDepart = secondes(p_depart);
+    const uint32_t limite = p_dureeMax >= AUCUNE - heureDepart ? AUCUNE - 1 : heureDepart + p_dureeMax;
+    p_arrivees.assign(m_stations.size(), AUCUNE);
+    p_contexte.pret.assign(m_stations.size(), AUCUNE);
+    p_contexte.aPieds.assign(m_stations.size(), 0);
+    p_contexte.stationMarche.assign(m_stations.size(), AUCUNE);
+    p_contexte.monteeVoyage.assign(m_voyages.size(), AUCUNE);
+    marcherDepuisOrigine(p_pointOrigine, heureDepart, p_contexte);
+    for (size_t s = 0; s < m_stations.size(); ++s)
+    {
+        if (p_contexte.stationMarche[s] != AUCUNE) p_arrivees[s] = p_contexte.pret[s];
+    }
+
+    auto premiere = lower_bound(m_connexions.begin(), m_connexions.end(), heureDepart,
+                                [](const Connexion &c, uint32_t h) { return c.heureDepart < h; });
+    for (auto c = premiere; c != m_connexions.end() && c->heureDepart <= limite; ++c)
+    {
+        uint32_t &montee = p_contexte.monteeVoyage[c->voyage];
+        if (montee == AUCUNE)
+        {
+            if (p_contexte.pret[c->stationDepart] > c->heureDepart) continue;
+            montee = static_cast<uint32_t>(c - m_connexions.begin());
+        }
+
+        const uint32_t s = c->stationArrivee;
+        p_arrivees[s] = min(p_arrivees[s], c->heureArrivee);
+        p_contexte.pret[s] = min(p_contexte.pret[s], c->heureArrivee + m_delaiCorrespondance[s]);
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+        {
+            const Transfert &transfert = m_transferts[t];
+            p_arrivees[transfert.station] = min(p_arrivees[transfert.station], c->heureArrivee + transfert.duree);
+            p_contexte.pret[transfert.station] = min(p_contexte.pret[transfert.station],
+                                                     c->heureArrivee + transfert.duree);
+        }
+    }
+    //une arrivée après la limite peut provenir d'une connexion non balayée qui l'aurait améliorée
+    for (auto &arrivee : p_arrivees)
+    {
+        if (arrivee > limite) arrivee = AUCUNE;
+    }
+
+    gettimeofday(&fin, nullptr);
+    p_tempsExecution = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+}
+
+//! \brief classe les stations en bandes isochrones selon leur durée de trajet
+//! \param[in] p_arrivees: les heures d'arrivée calculées par arriveesAuPlusTot()
+//! \param[in] p_depart: l'heure de départ ayant servi au calcul
+//! \param[in] p_limites: les limites croissantes des bandes en secondes (p. ex. 900, 1800, 2700 et 3600)
+//! \param[out] p_bandes: pour chaque station, l'indice de la première limite qui n'est pas dépassée, ou
+//! \param[out] p_limites.size() si la station est atteinte plus tard ou est inatteignable
+void MoteurCSA::bandesIsochrones(const vector<uint32_t> &p_arrivees, const Heure &p_depart,
+                                 const vector<unsigned int> &p_limites, vector<uint32_t> &p_bandes)
+{
+    const uint32_t heureDepart = secondes(p_depart);
+    p_bandes.resize(p_arrivees.size());
+    for (size_t s = 0; s < p_arrivees.size(); ++s)
+    {
+        if (p_arrivees[s] == AUCUNE)
+        {
+            p_bandes[s] = static_cast<uint32_t>(p_limites.size());
+            continue;
+        }
+        const unsigned int duree = p_arrivees[s] - heureDepart;
+        p_bandes[s] = static_cast<uint32_t>(lower_bound(p_limites.begin(), p_limites.end(), duree) -
+                                            p_limites.begin());
+    }
+}
+
+//! \brief affiche le nombre de stations de chaque bande isochrone
+void MoteurCSA::afficherIsochrones(const vector<uint32_t> &p_bandes, const vector<unsigned int> &p_limites) const
+{
+    vector<size_t> nbStations(p_limites.size() + 1, 0);
+    for (uint32_t bande : p_bandes) ++nbStations[bande];
+    unsigned int precedente = 0;
+    for (size_t b = 0; b < p_limites.size(); ++b)
+    {
+        cout << "Stations atteintes en " << precedente / 60 << " à " << p_limites[b] / 60 << " minutes: "
+             << nbStations[b] << endl;
+        precedente = p_limites[b];
+    }
+    cout << "Stations atteintes plus tard ou inatteignables: " << nbStations[p_limites.size()] << endl;
+}
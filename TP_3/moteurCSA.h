@@ -0,0 +1,126 @@
+//
+//  MoteurCSA.h
+//  Calcul d'itinéraires par l'algorithme Connection Scan (CSA) directement sur les arrêts de DonneesGTFS
+//
+
+#ifndef MOTEURCSA_H
+#define MOTEURCSA_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "indexSpatial.h"
+#include "identifiantsGTFS.h"
+#include "DonneesGTFS.h"
+
+//! \brief Déplacement d'un véhicule entre deux arrêts consécutifs d'un voyage
+struct Connexion
+{
+    uint32_t heureDepart;     /*!< en secondes depuis minuit */
+    uint32_t heureArrivee;    /*!< en secondes depuis minuit */
+    uint32_t stationDepart;   /*!< indice de station (ordre de DonneesGTFS::getStations()) */
+    uint32_t stationArrivee;
+    uint32_t voyage;          /*!< indice du voyage (ordre de DonneesGTFS::getVoyages()) */
+};
+
+//! \brief Espace de travail d'une requête CSA; chaque fil d'exécution possède le sien
+struct ContexteCSA
+{
+    std::vector<uint32_t> pret;           /*!< heure au plus tôt à laquelle on peut monter à bord à chaque station */
+    std::vector<uint32_t> parentMontee;   /*!< connexion de montée du trajet menant à la station, ou aucune */
+    std::vector<uint32_t> parentDescente; /*!< connexion de descente du trajet menant à la station */
+    std::vector<uint8_t> aPieds;          /*!< 1 si l'on marche ensuite de la station de descente vers la station */
+    std::vector<uint32_t> stationMarche;  /*!< station proche du point origine d'où l'on a marché jusqu'à la station
+                                               sans prendre de véhicule, ou aucune */
+    std::vector<uint32_t> monteeVoyage;   /*!< connexion où l'on est monté dans chaque voyage, ou aucune */
+    std::vector<uint32_t> marcheVersDestination; /*!< durée de marche de la station au point destination, ou infinie */
+    std::vector<std::pair<uint32_t, double> > stationsProches;
+    uint32_t monteeFinale;                /*!< dernier trajet de l'itinéraire trouvé */
+    uint32_t descenteFinale;
+    uint32_t stationFinale;               /*!< station d'où l'on marche vers le point destination */
+};
+
+//! \brief Trajet Pareto-optimal d'un profil: aucun autre ne part plus tard du point origine en arrivant aussi tôt
+struct TrajetProfil
+{
+    uint32_t depart;          /*!< heure de départ du point origine, en secondes depuis minuit */
+    uint32_t arrivee;         /*!< heure d'arrivée au point destination, en secondes depuis minuit */
+    uint32_t stationMontee;   /*!< station où l'on monte dans le premier véhicule */
+};
+
+//! \brief Espace de travail d'une requête de profil; chaque fil d'exécution possède le sien
+struct ContexteProfilCSA
+{
+    //profil de chaque station: (heure de départ, heure d'arrivée à destination) en ordre décroissant des départs
+    //et des arrivées; seules les montées à bord à la station y figurent
+    std::vector<std::vector<std::pair<uint32_t, uint32_t> > > profils;
+    std::vector<uint32_t> arriveeVoyage;         /*!< arrivée à destination en restant à bord de chaque voyage */
+    std::vector<uint32_t> marcheVersDestination;
+    std::vector<std::pair<uint32_t, double> > stationsProches;
+};
+
+//! \brief Moteur d'itinéraires Connection Scan: les connexions de tous les voyages sont triées par heure de départ
+//! \brief et parcourues une seule fois par requête. Les transferts de DonneesGTFS servent de trajets à pieds entre
+//! \brief stations (fermés transitivement: une marche peut enchaîner plusieurs transferts, y compris depuis une
+//! \brief station proche du point origine); changer de véhicule à une même station demande delaiMinCorrespondance
+//! \brief secondes, sauf si un transfert de la station vers elle-même indique un autre délai.
+//! \brief Ces règles sont volontairement plus permissives que celles du graphe de ReseauPartage, où l'on ne peut
+//! \brief attendre à une station qu'un autre voyage de la même ligne (et seulement hors des stations de transfert), et
+//! \brief où un transfert mène à une autre ligne: tout trajet du graphe est permis ici, de sorte que l'arrivée
+//! \brief trouvée n'est jamais plus tardive que celle du graphe, et elle est plus hâtive lorsque le meilleur trajet
+//! \brief change de ligne à une station qui n'est pas une station de transfert.
+//! \brief L'objet DonneesGTFS utilisé à la construction doit survivre au moteur.
+class MoteurCSA
+{
+public:
+
+    explicit MoteurCSA(const DonneesGTFS &p_gtfs);
+    MoteurCSA(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants);
+
+    size_t getNbConnexions() const;
+    unsigned int itineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                            const Coordonnees &p_pointDestination, bool p_afficherItineraire,
+                            long &p_tempsExecution, ContexteCSA &p_contexte) const;
+    void profil(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination, const Heure &p_debut,
+                const Heure &p_fin, std::vector<TrajetProfil> &p_trajets, long &p_tempsExecution,
+                ContexteProfilCSA &p_contexte) const;
+    void afficherProfil(const std::vector<TrajetProfil> &p_trajets) const;
+    void arriveesAuPlusTot(const Coordonnees &p_pointOrigine, const Heure &p_depart, unsigned int p_dureeMax,
+                           std::vector<uint32_t> &p_arrivees, long &p_tempsExecution, ContexteCSA &p_contexte) const;
+    static void bandesIsochrones(const std::vector<uint32_t> &p_arrivees, const Heure &p_depart,
+                                 const std::vector<unsigned int> &p_limites, std::vector<uint32_t> &p_bandes);
+    void afficherIsochrones(const std::vector<uint32_t> &p_bandes, const std::vector<unsigned int> &p_limites) const;
+
+    static constexpr unsigned int delaiMinCorrespondance = 60; /*!< en secondes */
+    static constexpr uint32_t inatteignable = 0xFFFFFFFF;      /*!< heure d'arrivée d'une station inatteignable */
+
+    //! \brief Trajet à pieds vers une autre station
+    struct Transfert
+    {
+        uint32_t station;
+        uint32_t duree;   /*!< en secondes */
+    };
+
+    static void construireTransferts(const IdentifiantsGTFS &p_identifiants, std::vector<uint32_t> &p_debutTransferts,
+                                     std::vector<Transfert> &p_transferts,
+                                     std::vector<uint32_t> &p_delaiCorrespondance);
+
+private:
+
+    void marcherDepuisOrigine(const Coordonnees &p_pointOrigine, uint32_t p_heureDebut, ContexteCSA &p_contexte) const;
+    uint32_t preparer(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination, uint32_t p_heureDebut,
+                      ContexteCSA &p_contexte) const;
+    void afficherItineraire(const DonneesGTFS &p_gtfs, uint32_t p_heureDebut, uint32_t p_duree,
+                            const ContexteCSA &p_contexte) const;
+
+    std::vector<Connexion> m_connexions;          /*!< triées par heure de départ */
+    std::vector<uint32_t> m_debutTransferts;      /*!< transferts de la station s: [m_debutTransferts[s], m_debutTransferts[s+1]) */
+    std::vector<Transfert> m_transferts;          /*!< durée de marche la plus courte, en enchaînant les transferts */
+    std::vector<uint32_t> m_delaiCorrespondance;  /*!< délai pour changer de véhicule à chaque station */
+    std::vector<const Station *> m_stations;      /*!< dans l'ordre de DonneesGTFS::getStations() */
+    std::vector<const Voyage *> m_voyages;        /*!< dans l'ordre de DonneesGTFS::getVoyages() */
+    IndexSpatial m_indexStations;
+};
+
+#endif //MOTEURCSA_H
@@ -0,0 +1,465 @@
+//
+//  MoteurRAPTOR.cpp
+//  Calcul d'itinéraires par rondes (RAPTOR) offrant les compromis entre heure d'arrivée et nombre de correspondances
+//
+
+#include "moteurRAPTOR.h"
+#include <algorithm>
+#include <random>
+#include <sys/time.h>
+
+using namespace std;
+
+namespace
+{
+    const uint32_t AUCUNE = numeric_limits<uint32_t>::max();
+
+    uint32_t secondes(const Heure &p_heure)
+    {
+        return static_cast<uint32_t>(p_heure - Heure(0, 0, 0));
+    }
+}
+
+//! \brief construit le moteur avec ses propres identifiants (voir le constructeur suivant)
+MoteurRAPTOR::MoteurRAPTOR(const DonneesGTFS &p_gtfs)
+        : MoteurRAPTOR(p_gtfs, IdentifiantsGTFS(p_gtfs))
+{
+}
+
+//! \brief regroupe les voyages en patrons et construit les trajets à pieds entre stations
+//! \brief un patron ne contient que des voyages qui ne se dépassent pas (condition FIFO nécessaire à RAPTOR);
+//! \brief les voyages d'une même suite de stations qui se dépassent sont répartis dans plusieurs patrons
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_identifiants: les identifiants de p_gtfs; ils peuvent être détruits après la construction
+MoteurRAPTOR::MoteurRAPTOR(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants)
+        : m_indexStations(p_gtfs.getStations())
+{
+    for (uint32_t s = 0; s < p_identifiants.getNbStations(); ++s)
+        m_stations.push_back(&p_identifiants.station(s));
+
+    //suite de stations et heures de chaque voyage: arrêts [debutSuite[v], debutSuite[v+1]) de suites et heures
+    const uint32_t nbVoyages = p_identifiants.getNbVoyages();
+    vector<uint32_t> debutSuite(1, 0), suites;
+    vector<HeuresArret> heuresArrets;
+    for (uint32_t v = 0; v < nbVoyages; ++v)
+    {
+        m_voyages.push_back(&p_identifiants.voyage(v));
+        for (const auto &arret : p_identifiants.voyage(v).getArrets())
+        {
+            suites.push_back(p_identifiants.indiceStation(arret->getStationId()));
+            heuresArrets.push_back({secondes(arret->getHeureArrivee()), secondes(arret->getHeureDepart())});
+        }
+        debutSuite.push_back(static_cast<uint32_t>(suites.size()));
+    }
+    auto heuresVoyage = [&](uint32_t v, size_t i) -> const HeuresArret & { return heuresArrets[debutSuite[v] + i]; };
+    auto nbArretsVoyage = [&](uint32_t v) { return debutSuite[v + 1] - debutSuite[v]; };
+
+    //voyages regroupés par (indice de ligne, suite de stations), puis par heure de départ dans chaque groupe
+    auto memeSuite = [&](uint32_t a, uint32_t b)
+    {
+        return nbArretsVoyage(a) == nbArretsVoyage(b) &&
+               equal(suites.begin() + debutSuite[a], suites.begin() + debutSuite[a + 1], suites.begin() + debutSuite[b]);
+    };
+    vector<uint32_t> ordre(nbVoyages);
+    for (uint32_t v = 0; v < nbVoyages; ++v) ordre[v] = v;
+    sort(ordre.begin(), ordre.end(), [&](uint32_t a, uint32_t b)
+    {
+        if (p_identifiants.ligneDuVoyage(a) != p_identifiants.ligneDuVoyage(b))
+            return p_identifiants.ligneDuVoyage(a) < p_identifiants.ligneDuVoyage(b);
+        if (!memeSuite(a, b))
+            return lexicographical_compare(suites.begin() + debutSuite[a], suites.begin() + debutSuite[a + 1],
+                                           suites.begin() + debutSuite[b], suites.begin() + debutSuite[b + 1]);
+        if (heuresVoyage(a, 0).depart != heuresVoyage(b, 0).depart)
+            return heuresVoyage(a, 0).depart < heuresVoyage(b, 0).depart;
+        return a < b;
+    });
+
+    auto precede = [&](uint32_t a, uint32_t b)
+    {
+        for (uint32_t i = 0; i < nbArretsVoyage(a); ++i)
+        {
+            if (heuresVoyage(a, i).arrivee > heuresVoyage(b, i).arrivee ||
+                heuresVoyage(a, i).depart > heuresVoyage(b, i).depart)
+                return false;
+        }
+        return true;
+    };
+
+    m_debutArretsPatron.push_back(0);
+    m_debutVoyagesPatron.push_back(0);
+    for (size_t debutGroupe = 0, finGroupe; debutGroupe < ordre.size(); debutGroupe = finGroupe)
+    {
+        const uint32_t premier = ordre[debutGroupe];
+        for (finGroupe = debutGroupe + 1; finGroupe < ordre.size(); ++finGroupe)
+        {
+            if (p_identifiants.ligneDuVoyage(ordre[finGroupe]) != p_identifiants.ligneDuVoyage(premier) ||
+                !memeSuite(ordre[finGroupe], premier))
+                break;
+        }
+
+        vector<vector<uint32_t> > patrons;
+        for (size_t k = debutGroupe; k < finGroupe; ++k)
+        {
+            const uint32_t v = ordre[k];
+            auto patron = find_if(patrons.begin(), patrons.end(),
+                                  [&](const vector<uint32_t> &p) { return precede(p.back(), v); });
+            if (patron == patrons.end())
+                patrons.emplace_back(1, v);
+            else
+                patron->push_back(v);
+        }
+
+        for (const auto &patron : patrons)
+        {
+            m_debutHeuresPatron.push_back(static_cast<uint32_t>(m_heures.size()));
+            m_stationsPatron.insert(m_stationsPatron.end(), suites.begin() + debutSuite[premier],
+                                    suites.begin() + debutSuite[premier + 1]);
+            m_debutArretsPatron.push_back(static_cast<uint32_t>(m_stationsPatron.size()));
+            for (uint32_t v : patron)
+                m_heures.insert(m_heures.end(), heuresArrets.begin() + debutSuite[v],
+                                heuresArrets.begin() + debutSuite[v + 1]);
+            m_voyagesPatron.insert(m_voyagesPatron.end(), patron.begin(), patron.end());
+            m_debutVoyagesPatron.push_back(static_cast<uint32_t>(m_voyagesPatron.size()));
+        }
+    }
+
+    vector<vector<pair<uint32_t, uint32_t> > > patronsParStation(m_stations.size());
+    for (uint32_t p = 0; p + 1 < m_debutArretsPatron.size(); ++p)
+    {
+        for (uint32_t i = 0; m_debutArretsPatron[p] + i < m_debutArretsPatron[p + 1]; ++i)
+            patronsParStation[m_stationsPatron[m_debutArretsPatron[p] + i]].emplace_back(p, i);
+    }
+    m_debutPatronsStation.push_back(0);
+    for (const auto &patrons : patronsParStation)
+    {
+        m_patronsStation.insert(m_patronsStation.end(), patrons.begin(), patrons.end());
+        m_debutPatronsStation.push_back(static_cast<uint32_t>(m_patronsStation.size()));
+    }
+
+    MoteurCSA::construireTransferts(p_identifiants, m_debutTransferts, m_transferts, m_delaiCorrespondance);
+}
+
+size_t MoteurRAPTOR::getNbPatrons() const
+{
+    return m_debutArretsPatron.size() - 1;
+}
+
+const MoteurRAPTOR::HeuresArret &MoteurRAPTOR::heures(uint32_t p_patron, uint32_t p_voyage, uint32_t p_position) const
+{
+    const uint32_t nbArrets = m_debutArretsPatron[p_patron + 1] - m_debutArretsPatron[p_patron];
+    return m_heures[m_debutHeuresPatron[p_patron] + p_voyage * nbArrets + p_position];
+}
+
+//! \brief rang du premier voyage du patron, parmi [0, p_limite), partant de p_position à p_heure ou plus tard
+//! \return AUCUNE si aucun voyage ne convient
+uint32_t MoteurRAPTOR::premierVoyage(uint32_t p_patron, uint32_t p_position, uint32_t p_heure, uint32_t p_limite) const
+{
+    uint32_t debut = 0, fin = p_limite;
+    while (debut < fin)
+    {
+        uint32_t milieu = debut + (fin - debut) / 2;
+        if (heures(p_patron, milieu, p_position).depart < p_heure)
+            debut = milieu + 1;
+        else
+            fin = milieu;
+    }
+    return debut < p_limite ? debut : AUCUNE;
+}
+
+//! \brief calcule l'ensemble Pareto des itinéraires (heure d'arrivée, nombre de correspondances)
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le moteur
+//! \param[in] p_nbCorrespondancesMax: nombre maximal de correspondances (la recherche fait au plus ce nombre + 1 rondes)
+//! \param[out] p_options: les itinéraires, par nombre croissant de correspondances et durée décroissante
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche en microsecondes
+//! \param[in,out] p_contexte: l'espace de travail du fil d'exécution appelant
+void MoteurRAPTOR::itineraires(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                               const Coordonnees &p_pointDestination, unsigned int p_nbCorrespondancesMax,
+                               vector<OptionRAPTOR> &p_options, long &p_tempsExecution,
+                               ContexteRAPTOR &p_contexte) const
+{
+    timeval debut, fin;
+    gettimeofday(&debut, nullptr);
+
+    const uint32_t nbStations = static_cast<uint32_t>(m_stations.size());
+    const uint32_t nbRondes = p_nbCorrespondancesMax + 1;
+    const uint32_t heureDebut = secondes(p_gtfs.getTempsDebut());
+    const EtiquetteRAPTOR vide = {AUCUNE, AUCUNE, AUCUNE, AUCUNE, AUCUNE, 0};
+
+    p_options.clear();
+    p_contexte.etiquettes.assign(static_cast<size_t>(nbRondes + 1) * nbStations, vide);
+    p_contexte.meilleurPret.assign(nbStations, AUCUNE);
+    p_contexte.marcheVersDestination.assign(nbStations, AUCUNE);
+    p_contexte.marquees.assign(nbStations, 0);
+    p_contexte.stationMarche.assign(nbStations, AUCUNE);
+    p_contexte.premierePosition.assign(getNbPatrons(), AUCUNE);
+
+    m_indexStations.indicesStationsProches(p_pointOrigine, IndexSpatial::distanceMaxMarche, p_contexte.stationsProches);
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        uint32_t pret = heureDebut + static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+        if (pret >= p_contexte.meilleurPret[station.first]) continue;
+        p_contexte.etiquettes[station.first].pret = pret;
+        p_contexte.meilleurPret[station.first] = pret;
+        p_contexte.marquees[station.first] = 1;
+        p_contexte.stationMarche[station.first] = station.first;
+    }
+    //ronde 0: les transferts (fermés transitivement) depuis les stations proches du point origine, comme MoteurCSA
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        const uint32_t s = station.first;
+        if (p_contexte.stationMarche[s] != s) continue;
+        for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+        {
+            const uint32_t pret = p_contexte.meilleurPret[s] + m_transferts[t].duree;
+            const uint32_t voisine = m_transferts[t].station;
+            if (pret >= p_contexte.meilleurPret[voisine]) continue;
+            p_contexte.etiquettes[voisine].pret = pret;
+            p_contexte.meilleurPret[voisine] = pret;
+            p_contexte.marquees[voisine] = 1;
+            p_contexte.stationMarche[voisine] = s;
+        }
+    }
+    m_indexStations.indicesStationsProches(p_pointDestination, IndexSpatial::distanceMaxMarche,
+                                           p_contexte.stationsProches);
+    for (const auto &station : p_contexte.stationsProches)
+    {
+        p_contexte.marcheVersDestination[station.first] =
+                static_cast<uint32_t>(station.second / IndexSpatial::vitesseDeMarche * 3600);
+    }
+
+    uint32_t meilleureArrivee = AUCUNE;
+    for (uint32_t k = 1; k <= nbRondes; ++k)
+    {
+        EtiquetteRAPTOR *ronde = &p_contexte.etiquettes[static_cast<size_t>(k) * nbStations];
+        p_contexte.pretRondePrecedente = p_contexte.meilleurPret;
+
+        //patrons desservant une station marquée, à partir de la première station marquée du patron
+        p_contexte.patronsAParcourir.clear();
+        for (uint32_t s = 0; s < nbStations; ++s)
+        {
+            if (!p_contexte.marquees[s]) continue;
+            p_contexte.marquees[s] = 0;
+            for (uint32_t e = m_debutPatronsStation[s]; e < m_debutPatronsStation[s + 1]; ++e)
+            {
+                uint32_t &position = p_contexte.premierePosition[m_patronsStation[e].first];
+                if (position == AUCUNE) p_contexte.patronsAParcourir.push_back(m_patronsStation[e].first);
+                position = min(position, m_patronsStation[e].second);
+            }
+        }
+        if (p_contexte.patronsAParcourir.empty()) break;
+
+        uint32_t arriveeRonde = meilleureArrivee;
+        EtiquetteRAPTOR finale = vide;
+        uint32_t stationFinale = AUCUNE;
+        p_contexte.ameliorees.clear();
+        for (uint32_t p : p_contexte.patronsAParcourir)
+        {
+            const uint32_t nbArrets = m_debutArretsPatron[p + 1] - m_debutArretsPatron[p];
+            const uint32_t nbVoyages = m_debutVoyagesPatron[p + 1] - m_debutVoyagesPatron[p];
+            uint32_t voyage = AUCUNE, montee = AUCUNE;
+            for (uint32_t i = p_contexte.premierePosition[p]; i < nbArrets; ++i)
+            {
+                const uint32_t s = m_stationsPatron[m_debutArretsPatron[p] + i];
+                if (voyage != AUCUNE)
+                {
+                    const uint32_t arrivee = heures(p, voyage, i).arrivee;
+                    if (p_contexte.marcheVersDestination[s] != AUCUNE &&
+                        arrivee + p_contexte.marcheVersDestination[s] < arriveeRonde)
+                    {
+                        arriveeRonde = arrivee + p_contexte.marcheVersDestination[s];
+                        finale = {arrivee + m_delaiCorrespondance[s], p, voyage, montee, i, 0};
+                        stationFinale = s;
+                    }
+                    const uint32_t pret = arrivee + m_delaiCorrespondance[s];
+                    if (pret < p_contexte.meilleurPret[s] && arrivee < arriveeRonde)
+                    {
+                        ronde[s] = {pret, p, voyage, montee, i, 0};
+                        p_contexte.meilleurPret[s] = pret;
+                        p_contexte.marquees[s] = 1;
+                        p_contexte.ameliorees.push_back(s);
+                    }
+                }
+                //peut-on monter à cette station dans un voyage plus tôt?
+                const uint32_t pretPrecedent = p_contexte.pretRondePrecedente[s];
+                if (pretPrecedent != AUCUNE &&
+                    (voyage == AUCUNE || pretPrecedent <= heures(p, voyage, i).depart))
+                {
+                    uint32_t plusTot = premierVoyage(p, i, pretPrecedent, voyage == AUCUNE ? nbVoyages : voyage);
+                    if (plusTot != AUCUNE)
+                    {
+                        voyage = plusTot;
+                        montee = i;
+                    }
+                }
+            }
+            p_contexte.premierePosition[p] = AUCUNE;
+        }
+
+        //trajets à pieds depuis les stations atteintes en véhicule pendant cette ronde; les étiquettes en véhicule
+        //sont copiées d'abord, car une marche peut remplacer ronde[s] sans battre l'arrivée en véhicule à s (elle
+        //ne bat que cette arrivée plus le délai de correspondance)
+        p_contexte.etiquettesVehicule.clear();
+        for (uint32_t s : p_contexte.ameliorees) p_contexte.etiquettesVehicule.push_back(ronde[s]);
+        for (size_t a = 0; a < p_contexte.ameliorees.size(); ++a)
+        {
+            const uint32_t s = p_contexte.ameliorees[a];
+            const EtiquetteRAPTOR etiquette = p_contexte.etiquettesVehicule[a];
+            const uint32_t arrivee = heures(etiquette.patron, etiquette.voyage, etiquette.posDescente).arrivee;
+            for (uint32_t t = m_debutTransferts[s]; t < m_debutTransferts[s + 1]; ++t)
+            {
+                const MoteurCSA::Transfert &transfert = m_transferts[t];
+                const uint32_t marche = p_contexte.marcheVersDestination[transfert.station];
+                if (marche != AUCUNE && arrivee + transfert.duree + marche < arriveeRonde)
+                {
+                    arriveeRonde = arrivee + transfert.duree + marche;
+                    finale = etiquette;
+                    finale.aPieds = 1;
+                    stationFinale = transfert.station;
+                }
+                if (arrivee + transfert.duree < p_contexte.meilleurPret[transfert.station] &&
+                    arrivee + transfert.duree < arriveeRonde)
+                {
+                    ronde[transfert.station] = etiquette;
+                    ronde[transfert.station].pret = arrivee + transfert.duree;
+                    ronde[transfert.station].aPieds = 1;
+                    p_contexte.meilleurPret[transfert.station] = arrivee + transfert.duree;
+                    p_contexte.marquees[transfert.station] = 1;
+                }
+            }
+        }
+
+        if (arriveeRonde < meilleureArrivee)
+        {
+            meilleureArrivee = arriveeRonde;
+            p_options.emplace_back();
+            p_options.back().duree = arriveeRonde - heureDebut;
+            reconstruire(p_contexte, k, finale, stationFinale, p_options.back());
+        }
+    }
+
+    gettimeofday(&fin, nullptr);
+    p_tempsExecution = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+}
+
+//! \brief reconstruit les étapes d'un itinéraire se terminant par l'étiquette p_finale de la ronde p_ronde,
+//! \brief puis par la marche de la station p_stationFinale vers le point destination
+//! \brief chaque étape précédente provient de la ronde la plus petite permettant la montée, ce qui minimise
+//! \brief le nombre de correspondances
+void MoteurRAPTOR::reconstruire(const ContexteRAPTOR &p_contexte, uint32_t p_ronde, const EtiquetteRAPTOR &p_finale,
+                                uint32_t p_stationFinale, OptionRAPTOR &p_option) const
+{
+    const size_t nbStations = m_stations.size();
+    p_option.stationFinale = p_stationFinale;
+    p_option.etapes.clear();
+
+    EtiquetteRAPTOR etiquette = p_finale;
+    for (uint32_t k = p_ronde; k > 0;)
+    {
+        const uint32_t p = etiquette.patron;
+        const uint32_t stationMontee = m_stationsPatron[m_debutArretsPatron[p] + etiquette.posMontee];
+        const uint32_t heureMontee = heures(p, etiquette.voyage, etiquette.posMontee).depart;
+        p_option.etapes.push_back({m_voyagesPatron[m_debutVoyagesPatron[p] + etiquette.voyage], stationMontee,
+                                   heureMontee, m_stationsPatron[m_debutArretsPatron[p] + etiquette.posDescente],
+                                   heures(p, etiquette.voyage, etiquette.posDescente).arrivee});
+
+        uint32_t j = 0;
+        while (j < k && p_contexte.etiquettes[j * nbStations + stationMontee].pret > heureMontee) ++j;
+        if (j == k) throw logic_error("MoteurRAPTOR::reconstruire(): étiquette de montée introuvable");
+        etiquette = p_contexte.etiquettes[j * nbStations + stationMontee];
+        k = j;
+    }
+    p_option.stationOrigine = p_contexte.stationMarche[p_option.etapes.back().stationMontee];
+    reverse(p_option.etapes.begin(), p_option.etapes.end());
+    p_option.nbCorrespondances = static_cast<unsigned int>(p_option.etapes.size()) - 1;
+}
+
+//! \brief affiche chaque option dans le format de ReseauGTFS::itineraire
+void MoteurRAPTOR::afficherOptions(const DonneesGTFS &p_gtfs, const vector<OptionRAPTOR> &p_options) const
+{
+    const Heure minuit(0, 0, 0);
+    const uint32_t heureDebut = secondes(p_gtfs.getTempsDebut());
+    for (const auto &option : p_options)
+    {
+        cout << endl << "=====================" << endl;
+        cout << "     ITINÉRAIRE      " << endl;
+        cout << "=====================" << endl << endl;
+        cout << "Nombre de correspondances: " << option.nbCorrespondances << endl;
+        cout << "Heure de départ du point d'origine: " << p_gtfs.getTempsDebut() << endl;
+        for (size_t k = 0; k < option.etapes.size(); ++k)
+        {
+            const EtapeRAPTOR &etape = option.etapes[k];
+            const Voyage &voyage = *m_voyages[etape.voyage];
+            if (k == 0)
+                cout << "Rendez vous à la station " << *m_stations[option.stationOrigine] << endl;
+            const uint32_t stationPrecedente = k == 0 ? option.stationOrigine : option.etapes[k - 1].stationDescente;
+            if (etape.stationMontee != stationPrecedente)
+                cout << "De cette station, rendez-vous à pieds à la station " << *m_stations[etape.stationMontee] << endl;
+            cout << "De cette station, prenez l'autobus numéro " << p_gtfs.getLignes().at(voyage.getLigne()).getNumero()
+                 << " à l'heure " << minuit.add_secondes(etape.heureMontee) << " Vers " << voyage.getDestination()
+                 << endl;
+            cout << "et arrêtez-vous à la station " << *m_stations[etape.stationDescente] << " à l'heure "
+                 << minuit.add_secondes(etape.heureDescente) << endl;
+        }
+        if (option.etapes.back().stationDescente != option.stationFinale)
+            cout << "De cette station, rendez-vous à pieds à la station " << *m_stations[option.stationFinale] << endl;
+        cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
+        cout << "Heure d'arrivée à la destination: " << minuit.add_secondes(heureDebut + option.duree) << endl;
+        cout << "Durée du trajet: " << option.duree / 3600 << " heures, " << option.duree % 3600 / 60 << " minutes, "
+             << option.duree % 60 << " secondes" << endl;
+    }
+}
+
+//! \brief compare, sur des requêtes entre points tirés au hasard dans le rectangle englobant les stations, la
+//! \brief meilleure option RAPTOR à l'itinéraire de MoteurCSA, qui suivent les mêmes règles de marche et de
+//! \brief correspondance; seul un trajet entièrement à pieds, qui n'est pas une option RAPTOR, peut être plus court
+//! \brief avec MoteurCSA
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_graine: la graine du tirage des points, pour des comparaisons reproductibles
+//! \param[out] p_rapport: chaque écart, puis leur nombre
+//! \return le nombre de requêtes dont les durées diffèrent (hors trajets entièrement à pieds)
+size_t MoteurRAPTOR::validerAvecCSA(const DonneesGTFS &p_gtfs, size_t p_nbRequetes, unsigned int p_graine,
+                                    ostream &p_rapport)
+{
+    if (p_gtfs.getStations().empty()) return 0;
+    double latMin = 90, latMax = -90, lonMin = 180, lonMax = -180;
+    for (const auto &station : p_gtfs.getStations())
+    {
+        latMin = min(latMin, station.second.getCoords().getLatitude());
+        latMax = max(latMax, station.second.getCoords().getLatitude());
+        lonMin = min(lonMin, station.second.getCoords().getLongitude());
+        lonMax = max(lonMax, station.second.getCoords().getLongitude());
+    }
+
+    const unsigned int nbCorrespondancesValidation = 30; //CSA ne limite pas les correspondances
+    const MoteurRAPTOR raptor(p_gtfs);
+    const MoteurCSA csa(p_gtfs);
+    ContexteRAPTOR contexteRAPTOR;
+    ContexteCSA contexteCSA;
+    vector<OptionRAPTOR> options;
+    mt19937 generateur(p_graine);
+    uniform_real_distribution<double> latitude(latMin, latMax), longitude(lonMin, lonMax);
+    size_t nbEcarts = 0, nbAPieds = 0;
+    for (size_t r = 0; r < p_nbRequetes; ++r)
+    {
+        const Coordonnees origine(latitude(generateur), longitude(generateur));
+        const Coordonnees destination(latitude(generateur), longitude(generateur));
+        long tempsExecution;
+        raptor.itineraires(p_gtfs, origine, destination, nbCorrespondancesValidation, options, tempsExecution,
+                           contexteRAPTOR);
+        const unsigned int dureeRAPTOR = options.empty() ? numeric_limits<unsigned int>::max() : options.back().duree;
+        const unsigned int dureeCSA = csa.itineraire(p_gtfs, origine, destination, false, tempsExecution,
+                                                     contexteCSA);
+        if (dureeCSA == dureeRAPTOR) continue;
+        if (dureeCSA < dureeRAPTOR && contexteCSA.monteeFinale == AUCUNE)
+        {
+            ++nbAPieds;
+            continue;
+        }
+        ++nbEcarts;
+        p_rapport << "Écart à la requête " << r << ": " << dureeRAPTOR << " s (RAPTOR) vs " << dureeCSA
+                  << " s (CSA)" << endl;
+    }
+    p_rapport << nbEcarts << " écart(s) sur " << p_nbRequetes << " requêtes (" << nbAPieds
+              << " trajet(s) entièrement à pieds plus courts avec CSA)" << endl;
+    return nbEcarts;
+}
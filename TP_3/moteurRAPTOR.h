@@ -0,0 +1,120 @@
+//
+//  MoteurRAPTOR.h
+//  Calcul d'itinéraires par rondes (RAPTOR) offrant les compromis entre heure d'arrivée et nombre de correspondances
+//
+
+#ifndef MOTEURRAPTOR_H
+#define MOTEURRAPTOR_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "indexSpatial.h"
+#include "moteurCSA.h"
+#include "identifiantsGTFS.h"
+#include "DonneesGTFS.h"
+
+//! \brief Trajet à bord d'un même voyage
+struct EtapeRAPTOR
+{
+    uint32_t voyage;            /*!< indice du voyage (ordre de DonneesGTFS::getVoyages()) */
+    uint32_t stationMontee;     /*!< indice de station (ordre de DonneesGTFS::getStations()) */
+    uint32_t heureMontee;       /*!< en secondes depuis minuit */
+    uint32_t stationDescente;
+    uint32_t heureDescente;
+};
+
+//! \brief Itinéraire Pareto-optimal: aucun autre n'arrive aussi tôt avec moins de correspondances
+struct OptionRAPTOR
+{
+    unsigned int duree;              /*!< durée du trajet en secondes */
+    unsigned int nbCorrespondances;  /*!< nombre de changements de véhicule */
+    std::vector<EtapeRAPTOR> etapes;
+    uint32_t stationOrigine;         /*!< station proche du point origine où l'on se rend à pieds */
+    uint32_t stationFinale;          /*!< station d'où l'on marche vers le point destination */
+};
+
+//! \brief Étiquette d'une station pour une ronde: heure à laquelle on peut y monter à bord et dernier trajet effectué
+struct EtiquetteRAPTOR
+{
+    uint32_t pret;         /*!< heure au plus tôt à laquelle on peut monter à bord à la station */
+    uint32_t patron;
+    uint32_t voyage;       /*!< rang du voyage dans son patron */
+    uint32_t posMontee;
+    uint32_t posDescente;
+    uint8_t aPieds;        /*!< 1 si l'on marche ensuite de la station de descente vers la station */
+};
+
+//! \brief Espace de travail d'une requête RAPTOR; chaque fil d'exécution possède le sien
+struct ContexteRAPTOR
+{
+    std::vector<EtiquetteRAPTOR> etiquettes;   /*!< (nbRondes + 1) x nbStations */
+    std::vector<uint32_t> meilleurPret;        /*!< meilleure heure de montée, toutes rondes confondues */
+    std::vector<uint32_t> pretRondePrecedente; /*!< meilleure heure de montée avec au plus k - 1 trajets */
+    std::vector<uint32_t> marcheVersDestination;
+    std::vector<uint8_t> marquees;
+    std::vector<uint32_t> stationMarche;       /*!< ronde 0: station proche du point origine d'où l'on a marché */
+    std::vector<uint32_t> ameliorees;          /*!< stations améliorées à bord d'un véhicule pendant la ronde */
+    std::vector<EtiquetteRAPTOR> etiquettesVehicule; /*!< étiquettes en véhicule des stations de ameliorees */
+    std::vector<uint32_t> premierePosition;    /*!< position la plus tôt d'une station marquée dans chaque patron */
+    std::vector<uint32_t> patronsAParcourir;
+    std::vector<std::pair<uint32_t, double> > stationsProches;
+};
+
+//! \brief Moteur RAPTOR: les voyages ayant la même ligne et la même suite de stations sont regroupés en patrons
+//! \brief dont les heures sont stockées dans des tableaux contigus. La ronde k trouve les meilleures heures de
+//! \brief montée avec k trajets, ce qui donne l'ensemble Pareto (heure d'arrivée, nombre de correspondances).
+//! \brief Les règles de marche et de correspondance sont celles de MoteurCSA, mais chaque option prend au moins un
+//! \brief véhicule: un trajet entièrement à pieds n'est pas une option.
+//! \brief L'objet DonneesGTFS utilisé à la construction doit survivre au moteur.
+class MoteurRAPTOR
+{
+public:
+
+    explicit MoteurRAPTOR(const DonneesGTFS &p_gtfs);
+    MoteurRAPTOR(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants);
+
+    size_t getNbPatrons() const;
+    void itineraires(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                     const Coordonnees &p_pointDestination, unsigned int p_nbCorrespondancesMax,
+                     std::vector<OptionRAPTOR> &p_options, long &p_tempsExecution, ContexteRAPTOR &p_contexte) const;
+    void afficherOptions(const DonneesGTFS &p_gtfs, const std::vector<OptionRAPTOR> &p_options) const;
+    static size_t validerAvecCSA(const DonneesGTFS &p_gtfs, size_t p_nbRequetes, unsigned int p_graine,
+                                 std::ostream &p_rapport);
+
+private:
+
+    struct HeuresArret
+    {
+        uint32_t arrivee;
+        uint32_t depart;
+    };
+
+    const HeuresArret &heures(uint32_t p_patron, uint32_t p_voyage, uint32_t p_position) const;
+    uint32_t premierVoyage(uint32_t p_patron, uint32_t p_position, uint32_t p_heure, uint32_t p_limite) const;
+    void reconstruire(const ContexteRAPTOR &p_contexte, uint32_t p_ronde, const EtiquetteRAPTOR &p_finale,
+                      uint32_t p_stationFinale, OptionRAPTOR &p_option) const;
+
+    //patrons: arrêts [m_debutArretsPatron[p], m_debutArretsPatron[p+1]) de m_stationsPatron,
+    //voyages [m_debutVoyagesPatron[p], m_debutVoyagesPatron[p+1]) de m_voyagesPatron, triés par heure de départ,
+    //heures du voyage v à la position i: m_heures[m_debutHeuresPatron[p] + v * nbArrets + i]
+    std::vector<uint32_t> m_debutArretsPatron;
+    std::vector<uint32_t> m_stationsPatron;
+    std::vector<uint32_t> m_debutVoyagesPatron;
+    std::vector<uint32_t> m_voyagesPatron;
+    std::vector<uint32_t> m_debutHeuresPatron;
+    std::vector<HeuresArret> m_heures;
+
+    std::vector<uint32_t> m_debutPatronsStation;                 /*!< (patron, position) desservant chaque station */
+    std::vector<std::pair<uint32_t, uint32_t> > m_patronsStation;
+    std::vector<uint32_t> m_debutTransferts;
+    std::vector<MoteurCSA::Transfert> m_transferts;
+    std::vector<uint32_t> m_delaiCorrespondance;
+
+    std::vector<const Station *> m_stations;
+    std::vector<const Voyage *> m_voyages;
+    IndexSpatial m_indexStations;
+};
+
+#endif //MOTEURRAPTOR_H
@@ -0,0 +1,128 @@
+//
+//  ReseauGlissant.cpp
+//  Réseau dont l'intervalle de temps avance sans relire les fichiers GTFS
+//
+
+#include "reseauGlissant.h"
+
+using namespace std;
+
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_debut: l'heure de départ des requêtes
+//! \param[in] p_dureeFenetre: la durée de l'intervalle de temps en secondes
+//! \param[in] p_modeAttente: construction des arcs d'attente
+//! \param[in] p_capaciteCache: le nombre maximal de durées conservées par itineraire() (0 pour ne rien conserver)
+//! \param[in] p_tailleCelluleCache, p_dureeTrancheCache: la précision du cache (voir CacheItineraires)
+//! \throws logic_error si p_debut n'appartient pas à l'intervalle de temps de p_gtfs
+ReseauGlissant::ReseauGlissant(const DonneesGTFS &p_gtfs, const Heure &p_debut, unsigned int p_dureeFenetre,
+                               ModeAttente p_modeAttente, size_t p_capaciteCache, double p_tailleCelluleCache,
+                               unsigned int p_dureeTrancheCache)
+        : m_gtfs(p_gtfs), m_identifiants(p_gtfs), m_dureeFenetre(p_dureeFenetre), m_modeAttente(p_modeAttente),
+          m_version(0)
+{
+    if (p_capaciteCache > 0)
+        m_cache.reset(new CacheItineraires(p_capaciteCache, p_tailleCelluleCache, p_dureeTrancheCache));
+    m_reseau = construire(p_debut);
+}
+
+//! \brief déplace l'intervalle de temps à [p_nouveauDebut, p_nouveauDebut + getDureeFenetre()), tronqué à la fin de
+//! \brief l'intervalle de DonneesGTFS; les requêtes continuent d'être servies par l'ancien réseau pendant la
+//! \brief construction
+//! \throws logic_error si p_nouveauDebut n'appartient pas à l'intervalle de temps de DonneesGTFS (le réseau courant
+//! \throws est alors conservé)
+void ReseauGlissant::avancer(const Heure &p_nouveauDebut)
+{
+    lock_guard<mutex> verrouAvancer(m_verrouAvancer);
+    shared_ptr<const ReseauPartage> nouveau = construire(p_nouveauDebut);
+    if (m_retards.getNbVoyages() > 0)
+        nouveau = make_shared<const ReseauPartage>(*nouveau, m_identifiants, m_retards, m_retards.getVoyages());
+    const uint32_t heureDepart = static_cast<uint32_t>(nouveau->getDebutFenetre() - Heure(0, 0, 0));
+    lock_guard<mutex> verrouReseau(m_verrouReseau);
+    m_reseau.swap(nouveau);
+    ++m_version;
+    if (m_cache) m_cache->changerFenetre(m_version, heureDepart);
+    //l'ancien réseau est libéré à la sortie, ou par la dernière requête qui l'utilise encore
+}
+
+//! \brief lit un fichier de retards (voir RetardsTempsReel::lire()) et remplace le réseau courant par une copie
+//! \brief dont seuls les arrêts des voyages retardés et les arcs qui en dépendent sont mis à jour; les requêtes
+//! \brief continuent d'être servies par l'ancien réseau pendant la mise à jour
+//! \return le nombre de lignes ignorées (voyages absents des données GTFS)
+//! \throws logic_error si le fichier ne peut être lu ou est invalide (le réseau courant est alors conservé)
+size_t ReseauGlissant::appliquerRetards(const string &p_fichier)
+{
+    lock_guard<mutex> verrouAvancer(m_verrouAvancer);
+    RetardsTempsReel retards(m_retards); //m_retards n'est remplacé qu'une fois le nouveau réseau construit
+    vector<uint32_t> voyagesModifies;
+    const size_t nbIgnorees = retards.lire(p_fichier, m_identifiants, voyagesModifies);
+    shared_ptr<const ReseauPartage> nouveau =
+            make_shared<const ReseauPartage>(*getReseau(), m_identifiants, retards, voyagesModifies);
+    m_retards = move(retards);
+    lock_guard<mutex> verrouReseau(m_verrouReseau);
+    m_reseau.swap(nouveau);
+    ++m_version;
+    if (m_cache) m_cache->invalider(m_version);
+    return nbIgnorees;
+}
+
+//! \return le réseau courant; il reste valide et inchangé tant que l'appelant le conserve
+shared_ptr<const ReseauPartage> ReseauGlissant::getReseau() const
+{
+    lock_guard<mutex> verrouReseau(m_verrouReseau);
+    return m_reseau;
+}
+
+//! \brief calcule un itinéraire sur le réseau courant (voir ReseauPartage::itineraire()), ou en retrouve la durée
+//! \brief dans le cache
+//! \brief le cache ne conserve que des durées, pas les chemins: un itinéraire à afficher (p_afficherItineraire)
+//! \brief ne consulte jamais le cache et est toujours calculé; seule sa durée y est ensuite mise
+//! \param[out] p_tempsExecution: le temps de la recherche en microsecondes, 0 si la durée provient du cache
+unsigned int ReseauGlissant::itineraire(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                        bool p_afficherItineraire, long &p_tempsExecution,
+                                        ContexteItineraire &p_contexte) const
+{
+    shared_ptr<const ReseauPartage> reseau;
+    uint64_t version;
+    {
+        lock_guard<mutex> verrouReseau(m_verrouReseau);
+        reseau = m_reseau;
+        version = m_version;
+    }
+    if (!m_cache)
+        return reseau->itineraire(m_gtfs, p_pointOrigine, p_pointDestination, p_afficherItineraire,
+                                  p_tempsExecution, p_contexte);
+
+    const uint32_t heureDepart = static_cast<uint32_t>(reseau->getDebutFenetre() - Heure(0, 0, 0));
+    unsigned int duree;
+    if (!p_afficherItineraire && m_cache->chercher(p_pointOrigine, p_pointDestination, heureDepart, version, duree))
+    {
+        p_tempsExecution = 0;
+        return duree;
+    }
+    duree = reseau->itineraire(m_gtfs, p_pointOrigine, p_pointDestination, p_afficherItineraire,
+                               p_tempsExecution, p_contexte);
+    m_cache->inserer(p_pointOrigine, p_pointDestination, heureDepart, version, duree);
+    return duree;
+}
+
+//! \return les compteurs du cache d'itinéraires (tous nuls s'il n'y a pas de cache)
+StatistiquesCache ReseauGlissant::getStatistiquesCache() const
+{
+    return m_cache ? m_cache->getStatistiques() : StatistiquesCache();
+}
+
+unsigned int ReseauGlissant::getDureeFenetre() const
+{
+    return m_dureeFenetre;
+}
+
+//! \brief construit le réseau de l'intervalle débutant à p_debut
+//! \throws logic_error si p_debut n'appartient pas à l'intervalle de temps de DonneesGTFS
+shared_ptr<const ReseauPartage> ReseauGlissant::construire(const Heure &p_debut) const
+{
+    if (p_debut > m_gtfs.getTempsFin() || m_gtfs.getTempsDebut() > p_debut)
+        throw logic_error("ReseauGlissant: l'heure de départ est hors de l'intervalle des données GTFS");
+    Heure fin = p_debut.add_secondes(m_dureeFenetre);
+    if (fin > m_gtfs.getTempsFin()) fin = m_gtfs.getTempsFin();
+    return make_shared<const ReseauPartage>(m_gtfs, m_identifiants, p_debut, fin, m_modeAttente);
+}
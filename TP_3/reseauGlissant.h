@@ -0,0 +1,64 @@
+//
+//  ReseauGlissant.h
+//  Réseau dont l'intervalle de temps avance sans relire les fichiers GTFS
+//
+
+#ifndef RESEAUGLISSANT_H
+#define RESEAUGLISSANT_H
+
+#include <memory>
+#include <mutex>
+
+#include "reseauPartage.h"
+#include "identifiantsGTFS.h"
+#include "retardsTempsReel.h"
+#include "cacheItineraires.h"
+#include "DonneesGTFS.h"
+
+//! \brief Sert les requêtes des p_dureeFenetre prochaines secondes à partir d'un objet DonneesGTFS chargé une seule
+//! \brief fois pour tout l'horizon de service (p. ex. de Heure(0, 0, 0) à Heure(30, 0, 0)).
+//! \brief avancer() retire les arrêts expirés et ajoute ceux entrés dans l'intervalle en construisant un nouveau
+//! \brief ReseauPartage à partir des voyages, stations et transferts déjà lus et indicés; le nouveau réseau remplace
+//! \brief l'ancien d'un seul coup. Une requête en cours garde le réseau qu'elle a obtenu de getReseau() jusqu'à la fin.
+//! \brief appliquerRetards() remplace de même le réseau par une copie tenant compte des retards lus; les retards en
+//! \brief vigueur sont appliqués de nouveau à chaque avancer().
+//! \brief Si p_capaciteCache n'est pas nulle, itineraire() conserve les durées calculées (pas les chemins, donc un
+//! \brief itinéraire à afficher est toujours calculé) dans un CacheItineraires;
+//! \brief avancer() n'y garde que les entrées de la tranche de la nouvelle heure de départ et appliquerRetards() le vide.
+//! \brief L'objet DonneesGTFS doit survivre au réseau glissant et aux réseaux qu'il a remis.
+class ReseauGlissant
+{
+public:
+
+    ReseauGlissant(const DonneesGTFS &p_gtfs, const Heure &p_debut, unsigned int p_dureeFenetre,
+                   ModeAttente p_modeAttente = ModeAttente::Complet, size_t p_capaciteCache = 0,
+                   double p_tailleCelluleCache = 0.2, unsigned int p_dureeTrancheCache = 300);
+    ReseauGlissant(const ReseauGlissant &) = delete;
+    ReseauGlissant &operator=(const ReseauGlissant &) = delete;
+
+    void avancer(const Heure &p_nouveauDebut);
+    size_t appliquerRetards(const std::string &p_fichier);
+    std::shared_ptr<const ReseauPartage> getReseau() const;
+    unsigned int itineraire(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                            bool p_afficherItineraire, long &p_tempsExecution, ContexteItineraire &p_contexte) const;
+    StatistiquesCache getStatistiquesCache() const;
+    unsigned int getDureeFenetre() const;
+
+private:
+
+    std::shared_ptr<const ReseauPartage> construire(const Heure &p_debut) const;
+
+    const DonneesGTFS &m_gtfs;
+    const IdentifiantsGTFS m_identifiants;
+    const unsigned int m_dureeFenetre; /*!< en secondes */
+    const ModeAttente m_modeAttente;
+
+    RetardsTempsReel m_retards;        /*!< protégé par m_verrouAvancer */
+    std::mutex m_verrouAvancer;        /*!< un seul avancer() ou appliquerRetards() à la fois */
+    mutable std::mutex m_verrouReseau; /*!< protège m_reseau, le temps d'en copier ou d'en remplacer le pointeur */
+    std::shared_ptr<const ReseauPartage> m_reseau;
+    uint64_t m_version;                /*!< incrémenté à chaque remplacement de m_reseau, protégé par m_verrouReseau */
+    std::unique_ptr<CacheItineraires> m_cache; /*!< nul si p_capaciteCache est nulle */
+};
+
+#endif //RESEAUGLISSANT_H
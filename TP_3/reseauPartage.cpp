@@ -0,0 +1,1198 @@
+//
+//  ReseauPartage.cpp
+//  Réseau GTFS immuable pouvant être interrogé simultanément par plusieurs fils d'exécution
+//
+
+#include "reseauPartage.h"
+#include "empreinteMemoire.h"
+#include "instantaneArrets.h"
+#include <algorithm>
+#include <unordered_map>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <tuple>
+#include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    //! \brief en-tête d'un instantané; suivi des sections (voir ReseauPartage::sauvegarderInstantane()), chacune
+    //! \brief alignée sur 8 octets
+    struct EnTeteInstantane
+    {
+        char magie[8];
+        uint32_t version;
+        uint32_t reserve;
+        uint64_t cle;
+        double secondesParKm;
+        uint64_t nbArrets;
+        uint64_t nbStations;
+        uint64_t nbVoyages;
+        uint64_t nbLiens;
+        uint64_t nbLiensRapides;
+    };
+
+    const char magieInstantane[8] = {'R', 'E', 'S', 'E', 'A', 'U', 'P', '1'};
+    const size_t alignementSections = 8;
+
+    //! \brief écrit les éléments de p_tableau, puis des zéros jusqu'au prochain multiple de alignementSections
+    template<typename T>
+    void ecrireSection(ostream &p_flux, const vector<T> &p_tableau)
+    {
+        const size_t octets = p_tableau.size() * sizeof(T);
+        const char zeros[alignementSections] = {};
+        p_flux.write(reinterpret_cast<const char *>(p_tableau.data()), octets);
+        p_flux.write(zeros, (alignementSections - octets % alignementSections) % alignementSections);
+    }
+
+    //! \return vrai si tous les éléments de p_indices sont inférieurs à p_borne
+    bool indicesValides(const vector<uint32_t> &p_indices, size_t p_borne)
+    {
+        return all_of(p_indices.begin(), p_indices.end(), [p_borne](uint32_t i) { return i < p_borne; });
+    }
+
+    //! \return vrai si p_debuts est un tableau de débuts de plages croissant de 0 à p_fin
+    bool debutsValides(const vector<uint32_t> &p_debuts, size_t p_fin)
+    {
+        return p_debuts.front() == 0 && p_debuts.back() == p_fin && is_sorted(p_debuts.begin(), p_debuts.end());
+    }
+
+    //! \brief lecture des sections successives d'un instantané projeté en mémoire
+    class LecteurSections
+    {
+    public:
+        LecteurSections(const char *p_debut, size_t p_taille) : m_position(p_debut), m_reste(p_taille)
+        {
+        }
+        //! \throws logic_error si la section déborde de l'instantané
+        template<typename T>
+        void lire(size_t p_nombre, vector<T> &p_tableau)
+        {
+            if (p_nombre > m_reste / sizeof(T)) throw logic_error("LecteurSections: instantané tronqué");
+            const T *debut = reinterpret_cast<const T *>(m_position);
+            p_tableau.assign(debut, debut + p_nombre);
+            avancer(p_nombre * sizeof(T));
+        }
+        //! \brief passe p_octets octets et le remplissage qui les suit
+        void avancer(size_t p_octets)
+        {
+            const size_t aligne = min(m_reste, p_octets + (alignementSections - p_octets % alignementSections) %
+                                                         alignementSections);
+            m_position += aligne;
+            m_reste -= aligne;
+        }
+        const char *position() const
+        {
+            return m_position;
+        }
+        size_t reste() const
+        {
+            return m_reste;
+        }
+    private:
+        const char *m_position;
+        size_t m_reste;
+    };
+
+    //! \brief fichier projeté en lecture seule, libéré à la destruction
+    class Projection
+    {
+    public:
+        explicit Projection(const string &p_fichier)
+        {
+            int fd = open(p_fichier.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            struct stat infos;
+            if (fstat(fd, &infos) == 0 && infos.st_size > 0)
+            {
+                void *projection = mmap(nullptr, static_cast<size_t>(infos.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (projection != MAP_FAILED)
+                {
+                    m_donnees = static_cast<const char *>(projection);
+                    m_taille = static_cast<size_t>(infos.st_size);
+                }
+            }
+            close(fd);
+        }
+        ~Projection()
+        {
+            if (m_donnees) munmap(const_cast<char *>(m_donnees), m_taille);
+        }
+        Projection(const Projection &) = delete;
+        Projection &operator=(const Projection &) = delete;
+        const char *donnees() const
+        {
+            return m_donnees;
+        }
+        size_t taille() const
+        {
+            return m_taille;
+        }
+    private:
+        const char *m_donnees = nullptr;
+        size_t m_taille = 0;
+    };
+}
+
+//! \brief construit le graphe du réseau à partir des données GTFS puis le fige
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_modeAttente: construction des arcs d'attente
+//! \post le graphe ne contient que les arcs de voyages, de transferts et d'attente; il n'est plus modifié ensuite
+ReseauPartage::ReseauPartage(const DonneesGTFS &p_gtfs, ModeAttente p_modeAttente)
+        : ReseauPartage(p_gtfs, IdentifiantsGTFS(p_gtfs), p_gtfs.getTempsDebut(), p_gtfs.getTempsFin(), p_modeAttente)
+{
+}
+
+//! \brief construit le graphe des seuls arrêts de l'intervalle [p_debut, p_fin), selon la règle de
+//! \brief DonneesGTFS::ajouterArretsDesVoyagesDeLaDate() (arrivée < p_fin et départ >= p_debut), puis le fige
+//! \brief les voyages, stations et transferts déjà lus et indicés sont réutilisés: aucun fichier n'est relu
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_identifiants: les identifiants de p_gtfs, qui peuvent servir à plusieurs réseaux
+//! \param[in] p_debut: l'heure de départ des requêtes
+//! \param[in] p_fin: la fin de l'intervalle de temps
+//! \throws logic_error si [p_debut, p_fin) déborde de l'intervalle de temps de p_gtfs
+ReseauPartage::ReseauPartage(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants, const Heure &p_debut,
+                             const Heure &p_fin, ModeAttente p_modeAttente)
+        : m_indexStations(p_gtfs.getStations()), m_debutFenetre(static_cast<uint32_t>(p_debut - Heure(0, 0, 0))),
+          m_finFenetre(static_cast<uint32_t>(p_fin - Heure(0, 0, 0))), m_secondesParKm(0),
+          m_chargeDeInstantane(false), m_modeAttente(p_modeAttente)
+{
+    if (p_gtfs.getTempsDebut() > p_debut || p_fin > p_gtfs.getTempsFin() || p_debut > p_fin)
+        throw logic_error("ReseauPartage: l'intervalle de temps déborde de celui des données GTFS");
+    numeroterArrets(p_identifiants);
+    associerStations(p_identifiants);
+    construireGraphe(p_identifiants);
+}
+
+//! \brief relit le réseau de l'instantané p_fichierInstantane s'il correspond aux fichiers GTFS, sinon construit
+//! \brief le réseau et (ré)écrit l'instantané
+//! \brief un instantané à jour est relu sans parcourir les arrêts de p_gtfs: seules les adresses des stations et
+//! \brief des voyages (pour l'affichage) en sont reprises
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés, lus des fichiers de
+//! \param[in] p_repertoireGTFS
+//! \param[in] p_repertoireGTFS: le répertoire des fichiers GTFS, dont la taille et la date de modification
+//! \param[in] identifient l'instantané
+//! \param[in] p_fichierInstantane: le nom du fichier de l'instantané
+//! \param[in] p_modeAttente: construction des arcs d'attente (un instantané d'un autre mode est reconstruit)
+//! \throws logic_error si l'instantané doit être écrit et que l'écriture échoue
+ReseauPartage::ReseauPartage(const DonneesGTFS &p_gtfs, const string &p_repertoireGTFS,
+                             const string &p_fichierInstantane, ModeAttente p_modeAttente)
+        : m_indexStations(p_gtfs.getStations()),
+          m_debutFenetre(static_cast<uint32_t>(p_gtfs.getTempsDebut() - Heure(0, 0, 0))),
+          m_finFenetre(static_cast<uint32_t>(p_gtfs.getTempsFin() - Heure(0, 0, 0))), m_secondesParKm(0),
+          m_chargeDeInstantane(false), m_modeAttente(p_modeAttente)
+{
+    const uint64_t cle = cleInstantane(p_gtfs, p_repertoireGTFS, p_modeAttente);
+    m_chargeDeInstantane = chargerInstantane(p_gtfs, p_fichierInstantane, cle);
+    if (m_chargeDeInstantane) return;
+
+    const IdentifiantsGTFS identifiants(p_gtfs);
+    numeroterArrets(identifiants);
+    associerStations(identifiants);
+    construireGraphe(identifiants);
+    sauvegarderInstantane(p_fichierInstantane, cle);
+}
+
+//! \brief copie p_reseau en y appliquant les retards en vigueur des voyages p_voyages; les heures des arrêts
+//! \brief sont recalculées à partir de l'horaire, et seuls les arcs qui en dépendent sont reconstruits
+//! \brief (voir mettreAJourArcs()). Le graphe n'est pas copié: il est construit directement à partir de celui de
+//! \brief p_reseau. Les arrêts gardent leur sommet, même si leur retard les fait sortir de
+//! \brief l'intervalle de temps du réseau.
+//! \param[in] p_reseau: le réseau courant, inchangé
+//! \param[in] p_identifiants: les identifiants ayant servi à construire p_reseau
+//! \param[in] p_retards: les retards en vigueur (RetardsTempsReel::retard())
+//! \param[in] p_voyages: les voyages dont les retards ont changé depuis p_reseau
+//! \throws logic_error si p_identifiants ne correspond pas au réseau
+ReseauPartage::ReseauPartage(const ReseauPartage &p_reseau, const IdentifiantsGTFS &p_identifiants,
+                             const RetardsTempsReel &p_retards, const vector<uint32_t> &p_voyages)
+        : m_indexStations(p_reseau.m_indexStations), m_arrets(p_reseau.m_arrets),
+          m_numeroDuVoyage(p_reseau.m_numeroDuVoyage), m_coordsStations(p_reseau.m_coordsStations),
+          m_stations(p_reseau.m_stations), m_voyages(p_reseau.m_voyages), m_debutFenetre(p_reseau.m_debutFenetre),
+          m_finFenetre(p_reseau.m_finFenetre), m_secondesParKm(p_reseau.m_secondesParKm),
+          m_debutLiensEntrants(p_reseau.m_debutLiensEntrants), m_liensEntrants(p_reseau.m_liensEntrants),
+          m_liensRapides(p_reseau.m_liensRapides), m_chargeDeInstantane(false), m_modeAttente(p_reseau.m_modeAttente)
+{
+    vector<uint32_t> sommetsModifies;
+    for (uint32_t voyage : p_voyages)
+        appliquerRetards(p_identifiants, p_retards, voyage, sommetsModifies);
+    if (sommetsModifies.empty())
+    {
+        m_leGraphe = p_reseau.m_leGraphe;
+        m_instantane = p_reseau.m_instantane;
+    }
+    else
+        mettreAJourArcs(p_identifiants, p_reseau.m_leGraphe, sommetsModifies);
+}
+
+//! \brief ajoute les arcs de voyages, de transferts et d'attente en parallèle puis fige le graphe
+//! \brief chaque fil d'exécution traite une tranche contiguë des sommets, des transferts et des stations et range ses
+//! \brief arcs dans ses propres tampons; la fusion par Graphe::figer() suit l'ordre (étape, tranche), de sorte que le
+//! \brief graphe obtenu est identique à celui d'une construction séquentielle, quel que soit le nombre de fils
+//! \throws logic_error si un fil d'exécution rencontre une incohérence
+void ReseauPartage::construireGraphe(const IdentifiantsGTFS &p_identifiants)
+{
+    const size_t nbFils = max<size_t>(1, min<size_t>(thread::hardware_concurrency(),
+                                                     m_arrets.size() / nbMinArretsParFil));
+    const size_t nbTransferts = p_identifiants.getTransferts().size();
+    const size_t nbStations = p_identifiants.getNbStations();
+    //tampons[etape * nbFils + tranche], étapes: voyages, transferts, attente
+    vector<TamponArcs> tampons(3 * nbFils);
+    vector<exception_ptr> erreurs(nbFils);
+
+    auto construireTranche = [&](size_t p_tranche)
+    {
+        try
+        {
+            ajouterArcsVoyages(tampons[p_tranche], m_arrets.size() * p_tranche / nbFils,
+                               m_arrets.size() * (p_tranche + 1) / nbFils);
+            ajouterArcsTransferts(p_identifiants, tampons[nbFils + p_tranche], nbTransferts * p_tranche / nbFils,
+                                  nbTransferts * (p_tranche + 1) / nbFils);
+            //les stations sont réparties selon leur nombre d'arrêts plutôt que leur nombre
+            auto stationDuRang = [&](size_t p_rang)
+            {
+                const uint32_t arret = static_cast<uint32_t>(m_arrets.size() * p_rang / nbFils);
+                return p_rang == nbFils ? nbStations : static_cast<size_t>(
+                        lower_bound(m_arrets.debutParStation.begin(), m_arrets.debutParStation.end() - 1, arret) -
+                        m_arrets.debutParStation.begin());
+            };
+            ajouterArcsAttente(p_identifiants, tampons[2 * nbFils + p_tranche], stationDuRang(p_tranche),
+                               stationDuRang(p_tranche + 1));
+        }
+        catch (...)
+        {
+            erreurs[p_tranche] = current_exception();
+        }
+    };
+
+    vector<thread> fils;
+    for (size_t i = 1; i < nbFils; ++i) fils.emplace_back(construireTranche, i);
+    construireTranche(0);
+    for (auto &fil : fils) fil.join();
+    for (const auto &erreur : erreurs)
+    {
+        if (erreur) rethrow_exception(erreur);
+    }
+
+    m_leGraphe.figer(tampons);
+    calculerBorneVitesse();
+    relierStations(p_identifiants, vector<uint8_t>(nbStations, 1));
+}
+
+size_t ReseauPartage::getNbArcs() const
+{
+    return m_leGraphe.getNbArcs();
+}
+
+size_t ReseauPartage::getNbSommets() const
+{
+    return m_leGraphe.getNbSommets();
+}
+
+double ReseauPartage::getDistMaxMarche() const
+{
+    return distanceMaxMarche;
+}
+
+//! \brief vitesse maximale (km/h) des voyages sur leurs segments d'au moins dureeMinSegment secondes, ou à pieds;
+//! \brief sert à la borne inférieure de A*
+//! \return numeric_limits<double>::infinity() si elle n'a pu être estimée
+double ReseauPartage::getVitesseMaxReseau() const
+{
+    return m_secondesParKm > 0 ? 3600 / m_secondesParKm : numeric_limits<double>::infinity();
+}
+
+//! \return l'heure de départ des requêtes (début de l'intervalle de temps du réseau)
+Heure ReseauPartage::getDebutFenetre() const
+{
+    return Heure(0, 0, 0).add_secondes(m_debutFenetre);
+}
+
+//! \return la fin (exclue) de l'intervalle de temps du réseau
+Heure ReseauPartage::getFinFenetre() const
+{
+    return Heure(0, 0, 0).add_secondes(m_finFenetre);
+}
+
+//! \return true si le graphe provient d'un instantané plutôt que d'une construction
+bool ReseauPartage::estChargeDeInstantane() const
+{
+    return m_chargeDeInstantane;
+}
+
+//! \brief ajoute à p_rapport le graphe, la table des arrêts, l'index spatial et les tables d'affichage du réseau
+void ReseauPartage::evaluerMemoire(RapportMemoire &p_rapport) const
+{
+    m_leGraphe.evaluerMemoire(p_rapport, "ReseauPartage::m_leGraphe");
+
+    PosteMemoire &arrets = p_rapport.ajouter("ReseauPartage::m_arrets");
+    arrets.elements = m_arrets.size();
+    for (const auto *tableau : {&m_arrets.station, &m_arrets.voyage, &m_arrets.arrivee, &m_arrets.depart,
+                                &m_arrets.sequence, &m_arrets.debutParStation, &m_arrets.parStation})
+        RapportMemoire::compter(arrets, *tableau);
+
+    m_indexStations.evaluerMemoire(p_rapport, "ReseauPartage::m_indexStations");
+
+    PosteMemoire &liens = p_rapport.ajouter("ReseauPartage liens entre stations");
+    liens.elements = m_liensEntrants.size();
+    RapportMemoire::compter(liens, m_debutLiensEntrants);
+    RapportMemoire::compter(liens, m_liensEntrants);
+    RapportMemoire::compter(liens, m_liensRapides);
+
+    PosteMemoire &tables = p_rapport.ajouter("ReseauPartage stations et voyages");
+    tables.elements = m_stations.size() + m_voyages.size();
+    RapportMemoire::compter(tables, m_numeroDuVoyage);
+    RapportMemoire::compter(tables, m_coordsStations);
+    RapportMemoire::compter(tables, m_stations);
+    RapportMemoire::compter(tables, m_voyages);
+}
+
+//! \return true si l'arrêt appartient à l'intervalle de temps du réseau
+bool ReseauPartage::estDansFenetre(const Arret &p_arret) const
+{
+    const Heure minuit(0, 0, 0);
+    return static_cast<uint32_t>(p_arret.getHeureArrivee() - minuit) < m_finFenetre &&
+           static_cast<uint32_t>(p_arret.getHeureDepart() - minuit) >= m_debutFenetre;
+}
+
+//! \brief remplit la table des arrêts de l'intervalle de temps: les sommets sont numérotés dans l'ordre des voyages,
+//! \brief puis des arrêts de chaque voyage
+//! \post le graphe a un sommet par arrêt retenu et aucun arc
+void ReseauPartage::numeroterArrets(const IdentifiantsGTFS &p_identifiants)
+{
+    const Heure minuit(0, 0, 0);
+    size_t nbArrets = 0;
+    for (uint32_t v = 0; v < p_identifiants.getNbVoyages(); ++v)
+        nbArrets += p_identifiants.voyage(v).getArrets().size();
+    m_arrets.station.reserve(nbArrets);
+    m_arrets.voyage.reserve(nbArrets);
+    m_arrets.arrivee.reserve(nbArrets);
+    m_arrets.depart.reserve(nbArrets);
+    m_arrets.sequence.reserve(nbArrets);
+
+    m_numeroDuVoyage.resize(p_identifiants.getNbVoyages());
+    for (uint32_t v = 0; v < p_identifiants.getNbVoyages(); ++v)
+    {
+        m_voyages.push_back(&p_identifiants.voyage(v));
+        m_numeroDuVoyage[v] = p_identifiants.numeroDuVoyage(v);
+        for (const auto &arret : p_identifiants.voyage(v).getArrets())
+        {
+            if (!estDansFenetre(*arret)) continue;
+            m_arrets.station.push_back(p_identifiants.indiceStation(arret->getStationId()));
+            m_arrets.voyage.push_back(v);
+            m_arrets.arrivee.push_back(static_cast<uint32_t>(arret->getHeureArrivee() - minuit));
+            m_arrets.depart.push_back(static_cast<uint32_t>(arret->getHeureDepart() - minuit));
+            m_arrets.sequence.push_back(arret->getNumeroSequence());
+        }
+    }
+    m_leGraphe = Graphe(m_arrets.size());
+}
+
+//! \brief range les arrêts de chaque station dans l'ordre de Station::getArrets() (heure de départ) et retient
+//! \brief les stations et leurs coordonnées
+void ReseauPartage::associerStations(const IdentifiantsGTFS &p_identifiants)
+{
+    //correspondance temporaire arrêt -> sommet, le temps de reprendre l'ordre des multimap des stations
+    unordered_map<const Arret *, uint32_t> sommetDeArret;
+    sommetDeArret.reserve(m_arrets.size());
+    uint32_t sommet = 0;
+    for (uint32_t v = 0; v < p_identifiants.getNbVoyages(); ++v)
+    {
+        for (const auto &arret : p_identifiants.voyage(v).getArrets())
+        {
+            if (estDansFenetre(*arret)) sommetDeArret.emplace(arret.get(), sommet++);
+        }
+    }
+
+    m_arrets.debutParStation.assign(1, 0);
+    m_arrets.parStation.reserve(m_arrets.size());
+    for (uint32_t s = 0; s < p_identifiants.getNbStations(); ++s)
+    {
+        m_stations.push_back(&p_identifiants.station(s));
+        m_coordsStations.push_back(p_identifiants.station(s).getCoords());
+        for (const auto &arret : p_identifiants.station(s).getArrets())
+        {
+            auto sommetArret = sommetDeArret.find(arret.second.get());
+            if (sommetArret != sommetDeArret.end()) m_arrets.parStation.push_back(sommetArret->second);
+        }
+        m_arrets.debutParStation.push_back(static_cast<uint32_t>(m_arrets.parStation.size()));
+    }
+}
+
+//! \brief premier arrêt de la station p_station dont l'heure de départ est >= p_heure
+//! \return une position dans m_arrets.parStation (la fin de la station si aucun arrêt ne convient)
+uint32_t ReseauPartage::premierDepart(uint32_t p_station, uint32_t p_heure) const
+{
+    auto debut = m_arrets.parStation.begin() + m_arrets.debutParStation[p_station];
+    auto fin = m_arrets.parStation.begin() + m_arrets.debutParStation[p_station + 1];
+    return static_cast<uint32_t>(
+            lower_bound(debut, fin, p_heure, [this](uint32_t a, uint32_t h) { return m_arrets.depart[a] < h; }) -
+            m_arrets.parStation.begin());
+}
+
+//! \brief ajout des arcs dus aux voyages entre les sommets de deux arrêts consécutifs d'un même voyage
+//! \brief seuls les arcs arrivant aux sommets [p_debut, p_fin) sont ajoutés à p_tampon
+void ReseauPartage::ajouterArcsVoyages(TamponArcs &p_tampon, size_t p_debut, size_t p_fin) const
+{
+    for (size_t sommet = max<size_t>(p_debut, 1); sommet < p_fin; ++sommet)
+    {
+        if (m_arrets.voyage[sommet] != m_arrets.voyage[sommet - 1]) continue;
+        p_tampon.ajouter(sommet - 1, sommet, m_arrets.arrivee[sommet] - m_arrets.arrivee[sommet - 1]);
+    }
+}
+
+//! \brief ajouts des arcs dus aux transferts entre stations
+//! \brief un arc relie un arrêt de la station A à chaque arrêt de la station B d'une autre ligne atteignable
+//! \brief en respectant le temps minimal de transfert
+//! \brief seuls les transferts [p_debut, p_fin) de IdentifiantsGTFS::getTransferts() sont traités
+void ReseauPartage::ajouterArcsTransferts(const IdentifiantsGTFS &p_identifiants, TamponArcs &p_tampon,
+                                          size_t p_debut, size_t p_fin) const
+{
+    for (size_t t = p_debut; t < p_fin; ++t)
+    {
+        const TransfertIndexe &transfert = p_identifiants.getTransferts()[t];
+        const uint32_t finB = m_arrets.debutParStation[transfert.stationArrivee + 1];
+        for (uint32_t k = m_arrets.debutParStation[transfert.stationDepart];
+             k < m_arrets.debutParStation[transfert.stationDepart + 1]; ++k)
+        {
+            const uint32_t sommetA = m_arrets.parStation[k];
+            const uint32_t arriveeA = m_arrets.arrivee[sommetA];
+            const uint32_t ligneA = m_numeroDuVoyage[m_arrets.voyage[sommetA]];
+
+            for (uint32_t l = premierDepart(transfert.stationArrivee, arriveeA + transfert.duree); l < finB; ++l)
+            {
+                const uint32_t sommetB = m_arrets.parStation[l];
+                if (ligneA != m_numeroDuVoyage[m_arrets.voyage[sommetB]])
+                    p_tampon.ajouter(sommetA, sommetB, m_arrets.depart[sommetB] - arriveeA);
+            }
+        }
+    }
+}
+
+//! \brief ajouts des arcs d'une station à elle-même pour les stations qui ne sont pas des stations de transfert
+//! \brief ModeAttente::Complet: un arc relie deux arrêts d'une même ligne à la station lorsque l'attente est d'au
+//! \brief moins delaisMinArcsAttente (nombre quadratique d'arcs par station et ligne)
+//! \brief ModeAttente::Lineaire: l'arrêt i n'est relié qu'aux arrêts k du mode complet (plus loin dans l'ordre des
+//! \brief départs, arrivant au moins delaisMinArcsAttente plus tard) qu'aucun arrêt m de ce mode, situé entre i et k
+//! \brief dans l'ordre des départs, ne relie déjà à k; le chemin i, m, ..., k a le même poids total (les poids sont
+//! \brief des différences d'heures). Les arcs ajoutés sont au plus ceux du mode complet, en pratique quelques-uns
+//! \brief par arrêt.
+//! \brief seules les stations [p_debut, p_fin) sont traitées
+void ReseauPartage::ajouterArcsAttente(const IdentifiantsGTFS &p_identifiants, TamponArcs &p_tampon,
+                                       size_t p_debut, size_t p_fin) const
+{
+    vector<pair<uint32_t, uint32_t> > arretsParLigne; //(ligne, sommet), regroupés par ligne dans l'ordre des heures
+    for (uint32_t s = static_cast<uint32_t>(p_debut); s < p_fin; ++s)
+    {
+        if (p_identifiants.estStationDeTransfert(s)) continue;
+
+        arretsParLigne.clear();
+        for (uint32_t k = m_arrets.debutParStation[s]; k < m_arrets.debutParStation[s + 1]; ++k)
+        {
+            const uint32_t sommet = m_arrets.parStation[k];
+            arretsParLigne.emplace_back(p_identifiants.ligneDuVoyage(m_arrets.voyage[sommet]), sommet);
+        }
+        stable_sort(arretsParLigne.begin(), arretsParLigne.end(),
+                    [](const pair<uint32_t, uint32_t> &a, const pair<uint32_t, uint32_t> &b) { return a.first < b.first; });
+
+        for (size_t debut = 0, fin = 0; debut < arretsParLigne.size(); debut = fin)
+        {
+            while (fin < arretsParLigne.size() && arretsParLigne[fin].first == arretsParLigne[debut].first) ++fin;
+            if (m_modeAttente == ModeAttente::Lineaire)
+            {
+                ajouterArcsAttenteLineaires(arretsParLigne.begin() + debut, arretsParLigne.begin() + fin, p_tampon);
+                continue;
+            }
+            for (size_t i = debut; i < fin; ++i)
+            {
+                for (size_t j = i + 1; j < fin; ++j)
+                {
+                    const uint32_t sommetI = arretsParLigne[i].second, sommetJ = arretsParLigne[j].second;
+                    int poids = static_cast<int>(m_arrets.arrivee[sommetJ]) - static_cast<int>(m_arrets.arrivee[sommetI]);
+                    if (poids >= static_cast<int>(delaisMinArcsAttente))
+                        p_tampon.ajouter(sommetI, sommetJ, poids);
+                }
+            }
+        }
+    }
+}
+
+//! \brief arcs d'attente ModeAttente::Lineaire entre les arrêts [p_debut, p_fin) d'une même ligne à une station,
+//! \brief rangés par heure de départ
+//! \brief pour chaque arrêt i, les arrêts suivants k sont parcourus dans l'ordre des départs; k est déjà atteint si
+//! \brief un arrêt m relié à i (directement ou non) et parcouru avant lui arrive au moins delaisMinArcsAttente avant
+//! \brief lui. Le parcours s'arrête lorsque tous les arrêts restants sont ainsi atteints.
+void ReseauPartage::ajouterArcsAttenteLineaires(vector<pair<uint32_t, uint32_t> >::iterator p_debut,
+                                                vector<pair<uint32_t, uint32_t> >::iterator p_fin,
+                                                TamponArcs &p_tampon) const
+{
+    const size_t nbArrets = static_cast<size_t>(p_fin - p_debut);
+    vector<uint32_t> arriveeMinSuivante(nbArrets + 1, numeric_limits<uint32_t>::max()); //des arrêts [k, fin)
+    for (size_t k = nbArrets; k-- > 0;)
+        arriveeMinSuivante[k] = min(arriveeMinSuivante[k + 1], m_arrets.arrivee[p_debut[k].second]);
+
+    for (size_t i = 0; i < nbArrets; ++i)
+    {
+        const uint32_t arriveeI = m_arrets.arrivee[p_debut[i].second];
+        uint32_t arriveeMinAtteinte = numeric_limits<uint32_t>::max(); //plus petite arrivée d'un arrêt atteint
+        for (size_t k = i + 1; k < nbArrets; ++k)
+        {
+            if (arriveeMinAtteinte != numeric_limits<uint32_t>::max() &&
+                arriveeMinSuivante[k] >= arriveeMinAtteinte + delaisMinArcsAttente)
+                break;
+            const uint32_t arriveeK = m_arrets.arrivee[p_debut[k].second];
+            if (arriveeK < arriveeI + delaisMinArcsAttente) continue;
+            if (arriveeMinAtteinte == numeric_limits<uint32_t>::max() ||
+                arriveeK < arriveeMinAtteinte + delaisMinArcsAttente)
+                p_tampon.ajouter(p_debut[i].second, p_debut[k].second, arriveeK - arriveeI);
+            arriveeMinAtteinte = min(arriveeMinAtteinte, arriveeK);
+        }
+    }
+}
+
+//! \brief estime la vitesse maximale des voyages sur leurs segments d'au moins dureeMinSegment secondes plutôt que
+//! \brief sur chaque arc: avec des heures arrondies à la minute, un arc isolé peut relier deux stations en 0 seconde
+//! \brief la consistance de la borne de A* ne dépend pas de cette estimation (voir construireHeuristique())
+//! \post m_secondesParKm ne dépasse pas le temps de marche d'un km, afin que la borne reste consistante sur les arcs
+//! \post vers le point destination
+void ReseauPartage::calculerBorneVitesse()
+{
+    double secondesParKm = 3600 / vitesseDeMarche;
+    size_t fin = 0; //premier arrêt atteint au moins dureeMinSegment secondes après l'arrêt debut, dans le même voyage
+    for (size_t debut = 0; debut < m_arrets.size(); ++debut)
+    {
+        fin = max(fin, debut + 1);
+        while (fin < m_arrets.size() && m_arrets.voyage[fin] == m_arrets.voyage[debut] &&
+               m_arrets.arrivee[fin] - m_arrets.arrivee[debut] < dureeMinSegment)
+            ++fin;
+        if (fin == m_arrets.size() || m_arrets.voyage[fin] != m_arrets.voyage[debut]) continue;
+        const double distance = m_coordsStations[m_arrets.station[debut]] - m_coordsStations[m_arrets.station[fin]];
+        if (distance > 0)
+            secondesParKm = min(secondesParKm, (m_arrets.arrivee[fin] - m_arrets.arrivee[debut]) / distance);
+    }
+    //marge contre les erreurs d'arrondi de l'inégalité du triangle en virgule flottante
+    m_secondesParKm = secondesParKm * (1 - 1e-9);
+    if (!(m_secondesParKm > 0))
+        cerr << "ReseauPartage: avertissement: aucune vitesse maximale, A* équivaudra à Dijkstra" << endl;
+}
+
+//! \brief regroupe les arcs de voyages et de transferts reliant deux stations distinctes en liens de durée minimale,
+//! \brief rangés par station d'arrivée, et retient les liens parcourus plus vite que m_secondesParKm
+//! \brief un arc de transfert dure au moins la durée minimale du transfert, qui sert donc de durée au lien
+//! \param[in] p_stationsRecalculees: p_stationsRecalculees[s] != 0 si les liens arrivant à s sont recalculés; les
+//! \param[in] liens arrivant aux autres stations sont conservés tels quels
+void ReseauPartage::relierStations(const IdentifiantsGTFS &p_identifiants, const vector<uint8_t> &p_stationsRecalculees)
+{
+    const uint32_t nbStations = static_cast<uint32_t>(m_coordsStations.size());
+    const vector<TransfertIndexe> &transferts = p_identifiants.getTransferts();
+
+    //transferts arrivant aux stations recalculées, par tri par dénombrement selon la station d'arrivée
+    vector<uint32_t> debutTransferts(nbStations + 1, 0);
+    for (const TransfertIndexe &transfert : transferts)
+    {
+        if (transfert.stationDepart != transfert.stationArrivee && p_stationsRecalculees[transfert.stationArrivee])
+            ++debutTransferts[transfert.stationArrivee + 1];
+    }
+    for (uint32_t s = 0; s < nbStations; ++s) debutTransferts[s + 1] += debutTransferts[s];
+    vector<const TransfertIndexe *> transfertsEntrants(debutTransferts[nbStations]);
+    vector<uint32_t> prochain(debutTransferts.begin(), debutTransferts.end() - 1);
+    for (const TransfertIndexe &transfert : transferts)
+    {
+        if (transfert.stationDepart != transfert.stationArrivee && p_stationsRecalculees[transfert.stationArrivee])
+            transfertsEntrants[prochain[transfert.stationArrivee]++] = &transfert;
+    }
+
+    vector<uint32_t> debutLiensEntrants(1, 0);
+    vector<LienStations> liensEntrants, liensRapides, candidats;
+    liensEntrants.reserve(m_liensEntrants.size());
+    liensRapides.reserve(m_liensRapides.size());
+    auto rapide = m_liensRapides.cbegin(); //les liens rapides sont rangés par station d'arrivée
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        if (!p_stationsRecalculees[s])
+        {
+            liensEntrants.insert(liensEntrants.end(), m_liensEntrants.begin() + m_debutLiensEntrants[s],
+                                 m_liensEntrants.begin() + m_debutLiensEntrants[s + 1]);
+            for (; rapide != m_liensRapides.cend() && rapide->stationArrivee == s; ++rapide)
+                liensRapides.push_back(*rapide);
+            debutLiensEntrants.push_back(static_cast<uint32_t>(liensEntrants.size()));
+            continue;
+        }
+        while (rapide != m_liensRapides.cend() && rapide->stationArrivee == s) ++rapide;
+
+        candidats.clear();
+        for (uint32_t k = m_arrets.debutParStation[s]; k < m_arrets.debutParStation[s + 1]; ++k)
+        {
+            const uint32_t sommet = m_arrets.parStation[k];
+            if (sommet > 0 && m_arrets.voyage[sommet] == m_arrets.voyage[sommet - 1] &&
+                m_arrets.station[sommet - 1] != s)
+                candidats.push_back({m_arrets.station[sommet - 1], s,
+                                     m_arrets.arrivee[sommet] - m_arrets.arrivee[sommet - 1]});
+        }
+        for (uint32_t t = debutTransferts[s]; t < debutTransferts[s + 1]; ++t)
+            candidats.push_back({transfertsEntrants[t]->stationDepart, s, transfertsEntrants[t]->duree});
+
+        //un seul lien, le plus court, par paire de stations
+        sort(candidats.begin(), candidats.end(), [](const LienStations &a, const LienStations &b)
+        {
+            return a.stationDepart < b.stationDepart || (a.stationDepart == b.stationDepart && a.dureeMin < b.dureeMin);
+        });
+        for (auto lien = candidats.begin(); lien != candidats.end(); ++lien)
+        {
+            if (lien != candidats.begin() && lien->stationDepart == prev(lien)->stationDepart) continue;
+            liensEntrants.push_back(*lien);
+            const double distance = m_coordsStations[lien->stationDepart] - m_coordsStations[s];
+            if (distance * m_secondesParKm * (1 + 1e-9) >= lien->dureeMin) liensRapides.push_back(*lien);
+        }
+        debutLiensEntrants.push_back(static_cast<uint32_t>(liensEntrants.size()));
+    }
+
+    m_debutLiensEntrants.swap(debutLiensEntrants);
+    m_liensEntrants.swap(liensEntrants);
+    m_liensRapides.swap(liensRapides);
+}
+
+//! \brief recalcule les heures des arrêts du voyage p_voyage: horaire plus retard en vigueur, sans qu'un arrêt
+//! \brief n'arrive avant le départ du précédent ni ne parte avant son arrivée
+//! \param[in,out] p_sommetsModifies: les sommets dont une heure a changé y sont ajoutés
+//! \throws logic_error si les arrêts du voyage ne correspondent pas aux sommets du réseau
+void ReseauPartage::appliquerRetards(const IdentifiantsGTFS &p_identifiants, const RetardsTempsReel &p_retards,
+                                     uint32_t p_voyage, vector<uint32_t> &p_sommetsModifies)
+{
+    const Heure minuit(0, 0, 0);
+    //les sommets d'un voyage sont consécutifs (voir numeroterArrets())
+    size_t sommet = static_cast<size_t>(lower_bound(m_arrets.voyage.begin(), m_arrets.voyage.end(), p_voyage) -
+                                        m_arrets.voyage.begin());
+    int64_t departPrecedent = -1;
+    for (const auto &arret : p_identifiants.voyage(p_voyage).getArrets())
+    {
+        if (!estDansFenetre(*arret)) continue;
+        if (sommet >= m_arrets.size() || m_arrets.voyage[sommet] != p_voyage ||
+            m_arrets.sequence[sommet] != arret->getNumeroSequence())
+            throw logic_error("ReseauPartage: les identifiants ne correspondent pas aux arrêts du réseau");
+
+        const int64_t retard = p_retards.retard(p_voyage, arret->getNumeroSequence());
+        const int64_t arrivee = max({int64_t(0), departPrecedent,
+                                     static_cast<int64_t>(arret->getHeureArrivee() - minuit) + retard});
+        const int64_t depart = max(arrivee, static_cast<int64_t>(arret->getHeureDepart() - minuit) + retard);
+        if (m_arrets.arrivee[sommet] != arrivee || m_arrets.depart[sommet] != depart)
+        {
+            m_arrets.arrivee[sommet] = static_cast<uint32_t>(arrivee);
+            m_arrets.depart[sommet] = static_cast<uint32_t>(depart);
+            p_sommetsModifies.push_back(static_cast<uint32_t>(sommet));
+        }
+        departPrecedent = depart;
+        ++sommet;
+    }
+}
+
+//! \brief reconstruit les arcs qui dépendent des heures des sommets p_sommetsModifies
+//! \brief Les arrêts des stations touchées sont triés de nouveau par heure de départ. Les arcs sortant des
+//! \brief arrêts des stations touchées (attente, transferts, voyages) et des stations ayant un transfert vers une
+//! \brief station touchée sont reconstruits selon les règles de construireGraphe(), dans le même ordre; l'arc de
+//! \brief voyage menant à un sommet modifié depuis un autre sommet est mis à jour sur place. Les autres arcs sont
+//! \brief copiés tels quels de p_grapheSource dans m_leGraphe. Seuls les liens arrivant aux stations d'un sommet
+//! \brief modifié ou de son successeur dans le voyage sont recalculés (voir relierStations()).
+//! \param[in] p_grapheSource: le graphe avant les retards (m_leGraphe est remplacé)
+void ReseauPartage::mettreAJourArcs(const IdentifiantsGTFS &p_identifiants, const Graphe &p_grapheSource,
+                                    const vector<uint32_t> &p_sommetsModifies)
+{
+    const size_t nbStations = m_stations.size();
+    vector<uint8_t> stationsModifiees(nbStations, 0);
+    for (uint32_t sommet : p_sommetsModifies) stationsModifiees[m_arrets.station[sommet]] = 1;
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        if (!stationsModifiees[s]) continue;
+        stable_sort(m_arrets.parStation.begin() + m_arrets.debutParStation[s],
+                    m_arrets.parStation.begin() + m_arrets.debutParStation[s + 1],
+                    [this](uint32_t a, uint32_t b) { return m_arrets.depart[a] < m_arrets.depart[b]; });
+    }
+
+    const vector<TransfertIndexe> &transferts = p_identifiants.getTransferts();
+    vector<uint8_t> stationsRecalculees(stationsModifiees);
+    for (const auto &transfert : transferts)
+    {
+        if (stationsModifiees[transfert.stationArrivee]) stationsRecalculees[transfert.stationDepart] = 1;
+    }
+
+    vector<uint8_t> sommetsRemplaces(m_arrets.size(), 0);
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        if (!stationsRecalculees[s]) continue;
+        for (uint32_t k = m_arrets.debutParStation[s]; k < m_arrets.debutParStation[s + 1]; ++k)
+            sommetsRemplaces[m_arrets.parStation[k]] = 1;
+    }
+
+    //mêmes étapes que construireGraphe(): voyages, transferts, puis attente
+    TamponArcs arcs;
+    for (size_t sommet = 0; sommet + 1 < m_arrets.size(); ++sommet)
+    {
+        if (sommetsRemplaces[sommet] && m_arrets.voyage[sommet + 1] == m_arrets.voyage[sommet])
+            arcs.ajouter(sommet, sommet + 1, m_arrets.arrivee[sommet + 1] - m_arrets.arrivee[sommet]);
+    }
+    for (size_t t = 0; t < transferts.size(); ++t)
+    {
+        if (stationsRecalculees[transferts[t].stationDepart]) ajouterArcsTransferts(p_identifiants, arcs, t, t + 1);
+    }
+    for (uint32_t s = 0; s < nbStations; ++s)
+    {
+        if (stationsRecalculees[s]) ajouterArcsAttente(p_identifiants, arcs, s, s + 1);
+    }
+    m_leGraphe = Graphe(p_grapheSource, sommetsRemplaces, arcs);
+
+    for (uint32_t sommet : p_sommetsModifies)
+    {
+        if (sommet > 0 && !sommetsRemplaces[sommet - 1] && m_arrets.voyage[sommet - 1] == m_arrets.voyage[sommet])
+            m_leGraphe.modifierPoids(sommet - 1, sommet, m_arrets.arrivee[sommet] - m_arrets.arrivee[sommet - 1]);
+    }
+    //un retard change la durée des segments de voyage arrivant à un sommet modifié et en partant
+    vector<uint8_t> stationsReliees(nbStations, 0);
+    for (uint32_t sommet : p_sommetsModifies)
+    {
+        if (sommet > 0 && m_arrets.voyage[sommet - 1] == m_arrets.voyage[sommet])
+            stationsReliees[m_arrets.station[sommet]] = 1;
+        if (sommet + 1 < m_arrets.size() && m_arrets.voyage[sommet + 1] == m_arrets.voyage[sommet])
+            stationsReliees[m_arrets.station[sommet + 1]] = 1;
+    }
+    //m_secondesParKm est conservée: les liens devenus plus rapides sont retenus par relierStations()
+    relierStations(p_identifiants, stationsReliees);
+}
+
+//! \brief compare les durées de trajet obtenues avec les deux modes de construction des arcs d'attente
+//! \brief les requêtes relient des stations tirées au hasard (distribution uniforme, graine fixe)
+//! \param[in] p_gtfs: un objet DonneesGTFS dont tous les arrêts et transferts ont été ajoutés
+//! \param[in] p_nbRequetes: le nombre de paires origine/destination comparées
+//! \param[in] p_graine: la graine du générateur pseudo-aléatoire
+//! \param[out] p_rapport: le nombre d'arcs de chaque mode et chaque écart trouvé y sont écrits
+//! \return le nombre de requêtes dont les durées diffèrent
+size_t ReseauPartage::validerModeAttente(const DonneesGTFS &p_gtfs, size_t p_nbRequetes, unsigned int p_graine,
+                                         ostream &p_rapport)
+{
+    const ReseauPartage complet(p_gtfs, ModeAttente::Complet);
+    const ReseauPartage lineaire(p_gtfs, ModeAttente::Lineaire);
+    p_rapport << "Arcs (mode complet): " << complet.getNbArcs() << endl;
+    p_rapport << "Arcs (mode linéaire): " << lineaire.getNbArcs() << endl;
+    if (complet.m_coordsStations.empty()) return 0;
+
+    mt19937 generateur(p_graine);
+    uniform_int_distribution<size_t> distribution(0, complet.m_coordsStations.size() - 1);
+    ContexteItineraire contexteComplet, contexteLineaire;
+    size_t nbEcarts = 0;
+    for (size_t r = 0; r < p_nbRequetes; ++r)
+    {
+        const Coordonnees &origine = complet.m_coordsStations[distribution(generateur)];
+        const Coordonnees &destination = complet.m_coordsStations[distribution(generateur)];
+        long tempsExecution;
+        unsigned int dureeComplet = complet.itineraire(p_gtfs, origine, destination, false, tempsExecution,
+                                                       contexteComplet);
+        unsigned int dureeLineaire = lineaire.itineraire(p_gtfs, origine, destination, false, tempsExecution,
+                                                         contexteLineaire);
+        if (dureeComplet != dureeLineaire)
+        {
+            ++nbEcarts;
+            p_rapport << "Écart à la requête " << r << ": " << dureeComplet << " s (complet) vs " << dureeLineaire
+                      << " s (linéaire)" << endl;
+        }
+    }
+    p_rapport << nbEcarts << " écart(s) sur " << p_nbRequetes << " requêtes" << endl;
+    return nbEcarts;
+}
+
+//! \brief clé d'un instantané: version et règles de construction, puis la clé des arrêts (date, intervalle de temps,
+//! \brief taille et date de modification de chaque fichier GTFS, voir InstantaneArrets::cle())
+uint64_t ReseauPartage::cleInstantane(const DonneesGTFS &p_gtfs, const string &p_repertoireGTFS,
+                                      ModeAttente p_modeAttente)
+{
+    Empreinte empreinte;
+    empreinte.ajouter(versionInstantane);
+    empreinte.ajouter(static_cast<uint32_t>(p_modeAttente));
+    empreinte.ajouter(delaisMinArcsAttente);
+    empreinte.ajouter(dureeMinSegment);
+    empreinte.ajouter(InstantaneArrets::cle(p_gtfs, p_repertoireGTFS));
+    return empreinte.valeur();
+}
+
+//! \brief relit le réseau d'un instantané projeté en mémoire; la projection reste ouverte et le graphe figé y est
+//! \brief lu sur place, le reste est copié dans les tableaux du réseau
+//! \return false si le fichier est absent, illisible, d'une autre version, d'une autre clé, ou si son nombre de
+//! \return stations ou de voyages diffère de p_gtfs; le réseau est alors inchangé
+bool ReseauPartage::chargerInstantane(const DonneesGTFS &p_gtfs, const string &p_fichier, uint64_t p_cle)
+{
+    shared_ptr<const Projection> projection = make_shared<const Projection>(p_fichier);
+    if (projection->taille() < sizeof(EnTeteInstantane)) return false;
+
+    EnTeteInstantane enTete;
+    memcpy(&enTete, projection->donnees(), sizeof(enTete));
+    if (memcmp(enTete.magie, magieInstantane, sizeof(magieInstantane)) != 0 ||
+        enTete.version != versionInstantane || enTete.cle != p_cle ||
+        enTete.nbStations != p_gtfs.getStations().size() || enTete.nbVoyages != p_gtfs.getVoyages().size())
+        return false;
+
+    TableArrets arrets;
+    vector<uint32_t> numeroDuVoyage, debutLiensEntrants;
+    vector<double> coordonnees;
+    vector<LienStations> liensEntrants, liensRapides;
+    Graphe graphe;
+    try
+    {
+        LecteurSections lecteur(projection->donnees() + sizeof(enTete), projection->taille() - sizeof(enTete));
+        for (vector<uint32_t> *tableau : {&arrets.station, &arrets.voyage, &arrets.arrivee, &arrets.depart,
+                                          &arrets.sequence})
+            lecteur.lire(enTete.nbArrets, *tableau);
+        lecteur.lire(enTete.nbStations + 1, arrets.debutParStation);
+        lecteur.lire(enTete.nbArrets, arrets.parStation);
+        lecteur.lire(enTete.nbVoyages, numeroDuVoyage);
+        lecteur.lire(2 * enTete.nbStations, coordonnees);
+        lecteur.lire(enTete.nbStations + 1, debutLiensEntrants);
+        lecteur.lire(enTete.nbLiens, liensEntrants);
+        lecteur.lire(enTete.nbLiensRapides, liensRapides);
+        lecteur.avancer(graphe.projeter(lecteur.position(), lecteur.reste()));
+        if (graphe.getNbSommets() != arrets.size() || !indicesValides(arrets.station, enTete.nbStations) ||
+            !indicesValides(arrets.voyage, enTete.nbVoyages) || !indicesValides(arrets.parStation, arrets.size()) ||
+            !debutsValides(arrets.debutParStation, arrets.size()) ||
+            !debutsValides(debutLiensEntrants, liensEntrants.size()))
+            return false;
+        for (const vector<LienStations> *liens : {&liensEntrants, &liensRapides})
+            for (const LienStations &lien : *liens)
+                if (lien.stationDepart >= enTete.nbStations || lien.stationArrivee >= enTete.nbStations)
+                    return false;
+    }
+    catch (const logic_error &)
+    {
+        return false; //instantané corrompu: il sera reconstruit
+    }
+
+    m_arrets = std::move(arrets);
+    m_numeroDuVoyage = std::move(numeroDuVoyage);
+    m_debutLiensEntrants = std::move(debutLiensEntrants);
+    m_liensEntrants = std::move(liensEntrants);
+    m_liensRapides = std::move(liensRapides);
+    m_leGraphe = std::move(graphe);
+    m_instantane = projection;
+    m_secondesParKm = enTete.secondesParKm;
+    m_coordsStations.reserve(enTete.nbStations);
+    for (size_t s = 0; s < enTete.nbStations; ++s)
+        m_coordsStations.emplace_back(coordonnees[2 * s], coordonnees[2 * s + 1]);
+    for (const auto &station : p_gtfs.getStations())
+        m_stations.push_back(&station.second);
+    for (const auto &voyage : p_gtfs.getVoyages())
+        m_voyages.push_back(&voyage.second);
+    return true;
+}
+
+//! \brief écrit l'instantané dans un fichier temporaire puis le renomme, afin qu'un lecteur ne voie jamais
+//! \brief un instantané partiel
+//! \brief sections: table des arrêts, numéro de ligne des voyages, coordonnées des stations, liens entre stations,
+//! \brief puis le graphe figé écrit par Graphe::sauvegarder()
+//! \throws logic_error si l'écriture échoue
+void ReseauPartage::sauvegarderInstantane(const string &p_fichier, uint64_t p_cle) const
+{
+    EnTeteInstantane enTete;
+    memcpy(enTete.magie, magieInstantane, sizeof(magieInstantane));
+    enTete.version = versionInstantane;
+    enTete.reserve = 0;
+    enTete.cle = p_cle;
+    enTete.secondesParKm = m_secondesParKm;
+    enTete.nbArrets = m_arrets.size();
+    enTete.nbStations = m_coordsStations.size();
+    enTete.nbVoyages = m_numeroDuVoyage.size();
+    enTete.nbLiens = m_liensEntrants.size();
+    enTete.nbLiensRapides = m_liensRapides.size();
+
+    vector<double> coordonnees;
+    coordonnees.reserve(2 * m_coordsStations.size());
+    for (const Coordonnees &coords : m_coordsStations)
+    {
+        coordonnees.push_back(coords.getLatitude());
+        coordonnees.push_back(coords.getLongitude());
+    }
+
+    const string temporaire = p_fichier + ".tmp";
+    {
+        ofstream flux(temporaire, ios::binary | ios::trunc);
+        flux.write(reinterpret_cast<const char *>(&enTete), sizeof(enTete));
+        for (const auto *tableau : {&m_arrets.station, &m_arrets.voyage, &m_arrets.arrivee, &m_arrets.depart,
+                                    &m_arrets.sequence, &m_arrets.debutParStation, &m_arrets.parStation,
+                                    &m_numeroDuVoyage})
+            ecrireSection(flux, *tableau);
+        ecrireSection(flux, coordonnees);
+        ecrireSection(flux, m_debutLiensEntrants);
+        ecrireSection(flux, m_liensEntrants);
+        ecrireSection(flux, m_liensRapides);
+        m_leGraphe.sauvegarder(flux);
+        if (!flux) throw logic_error("ReseauPartage: impossible d'écrire l'instantané " + temporaire);
+    }
+    if (rename(temporaire.c_str(), p_fichier.c_str()) != 0)
+        throw logic_error("ReseauPartage: impossible de renommer l'instantané " + temporaire);
+}
+
+//! \brief borne inférieure du temps restant: distance à vol d'oiseau de la station vers la destination parcourue à
+//! \brief la vitesse maximale des voyages, puis abaissée là où un lien plus rapide (heures arrondies, transfert très
+//! \brief court) la rendrait inconsistante: borne(a) <= dureeMin(a, b) + borne(b) est rétablie vers l'amont par un
+//! \brief Dijkstra inverse sur les liens entre stations, amorcé par les seuls liens en défaut. La borne est ainsi
+//! \brief consistante sur chaque arc, donc admissible, quelle que soit l'estimation de la vitesse maximale.
+void ReseauPartage::construireHeuristique(const Coordonnees &p_pointDestination, Heuristique &p_heuristique) const
+{
+    p_heuristique.groupeDuSommet = &m_arrets.station;
+    vector<unsigned int> &bornes = p_heuristique.bornesParGroupe;
+    bornes.resize(m_coordsStations.size());
+    for (size_t s = 0; s < m_coordsStations.size(); ++s)
+        bornes[s] = static_cast<unsigned int>((m_coordsStations[s] - p_pointDestination) * m_secondesParKm);
+
+    vector<pair<unsigned int, uint32_t> > &file = p_heuristique.aCorriger; //(borne, station), la plus petite en tête
+    const greater<pair<unsigned int, uint32_t> > plusPetite;
+    file.clear();
+    for (const LienStations &lien : m_liensRapides)
+    {
+        if (bornes[lien.stationDepart] > lien.dureeMin + bornes[lien.stationArrivee])
+            file.emplace_back(bornes[lien.stationArrivee], lien.stationArrivee);
+    }
+    make_heap(file.begin(), file.end(), plusPetite);
+    while (!file.empty())
+    {
+        pop_heap(file.begin(), file.end(), plusPetite);
+        const pair<unsigned int, uint32_t> station = file.back();
+        file.pop_back();
+        if (station.first != bornes[station.second]) continue; //entrée périmée
+        for (uint32_t k = m_debutLiensEntrants[station.second]; k < m_debutLiensEntrants[station.second + 1]; ++k)
+        {
+            const LienStations &lien = m_liensEntrants[k];
+            if (lien.dureeMin + station.first < bornes[lien.stationDepart])
+            {
+                bornes[lien.stationDepart] = lien.dureeMin + station.first;
+                file.emplace_back(bornes[lien.stationDepart], lien.stationDepart);
+                push_heap(file.begin(), file.end(), plusPetite);
+            }
+        }
+    }
+}
+
+//! \brief construit les arcs propres à une requête sans modifier le réseau
+//! \brief Il s'agit des arcs allant du point origine vers les arrêts des stations accessibles à pieds (le premier
+//! \brief arrêt de chaque ligne) et des arcs allant des arrêts des stations proches vers le point destination
+//! \brief l'heure de départ est le début de l'intervalle de temps du réseau
+//! \param[in] p_pointOrigine: les coordonnées GPS du point origine
+//! \param[in] p_pointDestination: les coordonnées GPS du point destination
+//! \param[out] p_surcouche: les arcs de la requête (son contenu précédent est effacé)
+void ReseauPartage::construireSurcouche(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                                        Surcouche &p_surcouche) const
+{
+    p_surcouche.clear();
+    ajouterArcsOrigine(p_pointOrigine, p_surcouche.arcsOrigine);
+    ajouterArcsDestination(p_pointDestination, p_surcouche.arcsDestination);
+}
+
+//! \brief arcs du point origine vers le premier arrêt de chaque ligne des stations accessibles à pieds
+void ReseauPartage::ajouterArcsOrigine(const Coordonnees &p_pointOrigine,
+                                       vector<pair<size_t, unsigned int> > &p_arcs) const
+{
+    const uint32_t tempsDebut = m_debutFenetre;
+    vector<uint32_t> lignesVues;
+    vector<pair<uint32_t, double> > stationsProches;
+    m_indexStations.indicesStationsProches(p_pointOrigine, distanceMaxMarche, stationsProches);
+    for (const auto &station : stationsProches)
+    {
+        unsigned int tempsMarche = static_cast<unsigned int>(station.second / vitesseDeMarche * 3600);
+        lignesVues.clear();
+        for (uint32_t k = premierDepart(station.first, tempsDebut + tempsMarche);
+             k < m_arrets.debutParStation[station.first + 1]; ++k)
+        {
+            const uint32_t sommet = m_arrets.parStation[k];
+            const uint32_t ligne = m_numeroDuVoyage[m_arrets.voyage[sommet]];
+            if (find(lignesVues.begin(), lignesVues.end(), ligne) == lignesVues.end())
+            {
+                lignesVues.push_back(ligne);
+                p_arcs.emplace_back(sommet, m_arrets.depart[sommet] - tempsDebut);
+            }
+        }
+    }
+}
+
+//! \brief arcs des arrêts des stations proches du point destination vers celui-ci (durée de la marche)
+void ReseauPartage::ajouterArcsDestination(const Coordonnees &p_pointDestination,
+                                           vector<pair<size_t, unsigned int> > &p_arcs) const
+{
+    vector<pair<uint32_t, double> > stationsProches;
+    m_indexStations.indicesStationsProches(p_pointDestination, distanceMaxMarche, stationsProches);
+    for (const auto &station : stationsProches)
+    {
+        unsigned int tempsMarche = static_cast<unsigned int>(station.second / vitesseDeMarche * 3600);
+        for (uint32_t k = m_arrets.debutParStation[station.first]; k < m_arrets.debutParStation[station.first + 1]; ++k)
+        {
+            p_arcs.emplace_back(m_arrets.parStation[k], tempsMarche);
+        }
+    }
+}
+
+//! \brief calcule le meilleur itinéraire entre deux points sans modifier le réseau
+//! \param[in] p_gtfs: l'objet DonneesGTFS ayant servi à construire le réseau
+//! \param[in] p_afficherItineraire: l'itinéraire est affiché lorsque true
+//! \param[out] p_tempsExecution: le temps d'exécution de la recherche en microsecondes
+//! \param[in,out] p_contexte: l'espace de travail du fil d'exécution appelant (p_contexte.aEtoile choisit A*); reçoit
+//! \param[in,out] l'effort de la recherche dans p_contexte.statistiques si statistiquesRechercheActives
+//! \return la durée du trajet en secondes (= numeric_limits<unsigned int>::max() si la destination est inatteignable)
+unsigned int ReseauPartage::itineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                                       const Coordonnees &p_pointDestination, bool p_afficherItineraire,
+                                       long &p_tempsExecution, ContexteItineraire &p_contexte) const
+{
+    timeval debut, fin;
+    if (statistiquesRechercheActives) gettimeofday(&debut, nullptr);
+    construireSurcouche(p_pointOrigine, p_pointDestination, p_contexte.surcouche);
+    const bool aEtoile = p_contexte.aEtoile && m_secondesParKm > 0;
+    if (aEtoile)
+        construireHeuristique(p_pointDestination, p_contexte.heuristique);
+    long tempsPreparation = 0;
+    if (statistiquesRechercheActives)
+    {
+        gettimeofday(&fin, nullptr);
+        tempsPreparation = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+    }
+
+    gettimeofday(&debut, nullptr);
+    unsigned int duree = m_leGraphe.plusCourtChemin(p_contexte.surcouche, p_contexte.chemin, p_contexte.recherche,
+                                                    aEtoile ? &p_contexte.heuristique : nullptr);
+    gettimeofday(&fin, nullptr);
+    p_tempsExecution = (fin.tv_sec - debut.tv_sec) * 1000000L + (fin.tv_usec - debut.tv_usec);
+    if (statistiquesRechercheActives)
+    {
+        p_contexte.statistiques = p_contexte.recherche.getStatistiques();
+        p_contexte.statistiques.microsecondesPreparation = tempsPreparation;
+    }
+
+    if (p_afficherItineraire && duree != numeric_limits<unsigned int>::max())
+        afficherItineraire(p_gtfs, p_contexte.chemin, duree);
+    return duree;
+}
+
+//! \brief affiche un itinéraire dont le chemin débute au sommet origine virtuel et se termine à la destination virtuelle
+void ReseauPartage::afficherItineraire(const DonneesGTFS &p_gtfs, const vector<size_t> &p_chemin,
+                                       unsigned int p_duree) const
+{
+    const Heure minuit(0, 0, 0);
+
+    cout << endl << "=====================" << endl;
+    cout << "     ITINÉRAIRE      " << endl;
+    cout << "=====================" << endl << endl;
+    cout << "Heure de départ du point d'origine: " << getDebutFenetre() << endl;
+
+    if (p_chemin.size() > 2)
+    {
+        cout << "Rendez vous à la station " << *m_stations[m_arrets.station[p_chemin[1]]] << endl;
+
+        //on parcourt le chemin par séquences d'arrêts consécutifs d'un même voyage
+        size_t i = 1;
+        while (i + 1 < p_chemin.size())
+        {
+            const size_t montee = p_chemin[i];
+            size_t j = i;
+            while (j + 2 < p_chemin.size() && m_arrets.voyage[p_chemin[j + 1]] == m_arrets.voyage[montee])
+                ++j;
+            const size_t descente = p_chemin[j];
+
+            if (j > i)
+            {
+                const Voyage &voyage = *m_voyages[m_arrets.voyage[montee]];
+                cout << "De cette station, prenez l'autobus numéro "
+                     << p_gtfs.getLignes().at(voyage.getLigne()).getNumero() << " à l'heure "
+                     << minuit.add_secondes(m_arrets.depart[montee]) << " Vers " << voyage.getDestination() << endl;
+                cout << "et arrêtez-vous à la station " << *m_stations[m_arrets.station[descente]]
+                     << " à l'heure " << minuit.add_secondes(m_arrets.arrivee[descente]) << endl;
+            }
+            if (j + 2 < p_chemin.size() && m_arrets.station[p_chemin[j + 1]] != m_arrets.station[descente])
+            {
+                cout << "De cette station, rendez-vous à pieds à la station "
+                     << *m_stations[m_arrets.station[p_chemin[j + 1]]] << endl;
+            }
+            i = j + 1;
+        }
+    }
+
+    cout << "Déplacez-vous à pieds de cette station au point destination" << endl;
+    cout << "Heure d'arrivée à la destination: " << getDebutFenetre().add_secondes(p_duree) << endl;
+    cout << "Durée du trajet: " << p_duree / 3600 << " heures, " << p_duree % 3600 / 60 << " minutes, "
+         << p_duree % 60 << " secondes" << endl;
+}
+
+//! \brief calcule la durée du meilleur trajet de chaque origine vers chaque destination, identique à celle de
+//! \brief itineraire(); une seule recherche est menée par origine, arrêtée dès que les durées de toutes les
+//! \brief destinations sont connues (voir Graphe::plusCourtesDistances()), et les origines sont réparties entre
+//! \brief p_nbFils fils d'exécution qui partagent le réseau
+//! \param[in] p_origines: les coordonnées des points origine
+//! \param[in] p_destinations: les coordonnées des points destination
+//! \param[in] p_nbFils: le nombre de fils d'exécution (0: un par cœur)
+//! \param[out] p_matrice: les durées, rangées par origine
+//! \throws logic_error si un fil d'exécution rencontre une incohérence
+void ReseauPartage::matriceDurees(const vector<Coordonnees> &p_origines, const vector<Coordonnees> &p_destinations,
+                                  unsigned int p_nbFils, MatriceDurees &p_matrice) const
+{
+    p_matrice.nbOrigines = static_cast<uint32_t>(p_origines.size());
+    p_matrice.nbDestinations = static_cast<uint32_t>(p_destinations.size());
+    p_matrice.durees.assign(p_origines.size() * p_destinations.size(), numeric_limits<unsigned int>::max());
+
+    //sommets reliés aux destinations, regroupés une seule fois: chaque cible mène à ses destinations
+    vector<tuple<uint32_t, uint32_t, unsigned int> > arcsCibles; //(sommet, destination, marche)
+    for (size_t d = 0; d < p_destinations.size(); ++d)
+    {
+        vector<pair<size_t, unsigned int> > arcs;
+        ajouterArcsDestination(p_destinations[d], arcs);
+        for (const auto &arc : arcs)
+            arcsCibles.emplace_back(static_cast<uint32_t>(arc.first), static_cast<uint32_t>(d), arc.second);
+    }
+    sort(arcsCibles.begin(), arcsCibles.end());
+    CiblesDistances cibles;
+    cibles.nbDestinations = static_cast<uint32_t>(p_destinations.size());
+    for (const auto &arc : arcsCibles)
+    {
+        if (cibles.sommets.empty() || cibles.sommets.back() != get<0>(arc))
+        {
+            cibles.sommets.push_back(get<0>(arc));
+            cibles.debut.push_back(static_cast<uint32_t>(cibles.arcs.size()));
+        }
+        cibles.arcs.emplace_back(get<1>(arc), get<2>(arc));
+    }
+    cibles.debut.push_back(static_cast<uint32_t>(cibles.arcs.size()));
+
+    const size_t nbFils = max<size_t>(1, min<size_t>(p_nbFils ? p_nbFils : thread::hardware_concurrency(),
+                                                     p_origines.size()));
+    atomic<size_t> prochaineOrigine(0);
+    vector<exception_ptr> erreurs(nbFils);
+    auto calculer = [&](size_t p_fil)
+    {
+        try
+        {
+            Surcouche surcouche;
+            ContexteRecherche contexte;
+            vector<unsigned int> distances;
+            for (size_t o = prochaineOrigine++; o < p_origines.size(); o = prochaineOrigine++)
+            {
+                surcouche.clear();
+                ajouterArcsOrigine(p_origines[o], surcouche.arcsOrigine);
+                m_leGraphe.plusCourtesDistances(surcouche, cibles, distances, contexte);
+                copy(distances.begin(), distances.end(), p_matrice.durees.begin() + o * p_destinations.size());
+            }
+        }
+        catch (...)
+        {
+            erreurs[p_fil] = current_exception();
+        }
+    };
+
+    vector<thread> fils;
+    for (size_t i = 1; i < nbFils; ++i) fils.emplace_back(calculer, i);
+    calculer(0);
+    for (auto &fil : fils) fil.join();
+    for (const auto &erreur : erreurs)
+    {
+        if (erreur) rethrow_exception(erreur);
+    }
+}
@@ -0,0 +1,171 @@
+//
+//  ReseauPartage.h
+//  Réseau GTFS immuable pouvant être interrogé simultanément par plusieurs fils d'exécution
+//
+
+#ifndef RESEAUPARTAGE_H
+#define RESEAUPARTAGE_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include "graphe.h"
+#include "indexSpatial.h"
+#include "identifiantsGTFS.h"
+#include "matriceDurees.h"
+#include "retardsTempsReel.h"
+#include "DonneesGTFS.h"
+
+//! \brief Espace de travail d'une requête d'itinéraire; chaque fil d'exécution possède le sien
+struct ContexteItineraire
+{
+    Surcouche surcouche;
+    ContexteRecherche recherche;
+    std::vector<size_t> chemin;
+    Heuristique heuristique;
+    bool aEtoile = true; /*!< recherche A* guidée par la distance à vol d'oiseau (même durée que Dijkstra) */
+    StatistiquesRecherche statistiques; /*!< effort de la dernière requête (si statistiquesRechercheActives) */
+};
+
+//! \brief Arrêts du réseau en tableaux parallèles: l'indice d'un arrêt est son numéro de sommet
+struct TableArrets
+{
+    std::vector<uint32_t> station;   /*!< indice de station (IdentifiantsGTFS) */
+    std::vector<uint32_t> voyage;    /*!< indice de voyage (IdentifiantsGTFS) */
+    std::vector<uint32_t> arrivee;   /*!< en secondes depuis minuit */
+    std::vector<uint32_t> depart;    /*!< en secondes depuis minuit */
+    std::vector<uint32_t> sequence;
+    //arrêts de la station s: parStation[debutParStation[s] .. debutParStation[s+1]), triés par heure de départ
+    std::vector<uint32_t> debutParStation;
+    std::vector<uint32_t> parStation;
+
+    size_t size() const
+    {
+        return station.size();
+    }
+};
+
+//! \brief Lien entre deux stations distinctes: aucun arc de voyage ou de transfert de la première vers la seconde
+//! \brief ne dure moins de dureeMin secondes
+struct LienStations
+{
+    uint32_t stationDepart;
+    uint32_t stationArrivee;
+    uint32_t dureeMin;
+};
+
+//! \brief Construction des arcs d'attente d'une station à elle-même (mêmes durées de trajet dans les deux cas)
+enum class ModeAttente
+{
+    Complet,  /*!< un arc entre chaque paire d'arrêts d'une même ligne (comme ReseauGTFS) */
+    Lineaire  /*!< chaque arrêt n'est relié qu'aux prochaines occasions d'attente */
+};
+
+//! \brief Réseau GTFS dont le graphe n'est plus jamais modifié après sa construction
+//! \brief Le graphe est construit selon les mêmes règles que ReseauGTFS (sommets numérotés dans le même ordre),
+//! \brief mais les arcs du point origine et vers le point destination vivent dans une Surcouche propre à chaque
+//! \brief requête au lieu d'être ajoutés puis enlevés du graphe.
+//! \brief L'objet DonneesGTFS utilisé à la construction doit survivre au réseau.
+//! \brief Le réseau (table des arrêts, stations, liens entre stations et graphe) peut être conservé dans un
+//! \brief instantané binaire propre aux fichiers GTFS (taille et date de modification), à la date et à l'intervalle de
+//! \brief temps; il est alors relu par projection en mémoire, le graphe figé étant lu sur place dans la projection,
+//! \brief au lieu d'être reconstruit. Les données GTFS doivent tout de même avoir été lues (affichage des stations
+//! \brief et des voyages).
+//! \brief Un réseau peut aussi ne couvrir qu'une partie de l'intervalle de temps de DonneesGTFS (voir ReseauGlissant).
+//! \brief Un réseau tenant compte de retards en temps réel est une copie mise à jour d'un autre réseau, qui reste
+//! \brief intact pour les requêtes en cours.
+class ReseauPartage
+{
+public:
+
+    explicit ReseauPartage(const DonneesGTFS &p_gtfs, ModeAttente p_modeAttente = ModeAttente::Complet);
+    ReseauPartage(const DonneesGTFS &p_gtfs, const IdentifiantsGTFS &p_identifiants, const Heure &p_debut,
+                  const Heure &p_fin, ModeAttente p_modeAttente = ModeAttente::Complet);
+    ReseauPartage(const DonneesGTFS &p_gtfs, const std::string &p_repertoireGTFS, const std::string &p_fichierInstantane,
+                  ModeAttente p_modeAttente = ModeAttente::Complet);
+    ReseauPartage(const ReseauPartage &p_reseau, const IdentifiantsGTFS &p_identifiants,
+                  const RetardsTempsReel &p_retards, const std::vector<uint32_t> &p_voyages);
+
+    size_t getNbArcs() const;
+    size_t getNbSommets() const;
+    double getDistMaxMarche() const;
+    double getVitesseMaxReseau() const;
+    Heure getDebutFenetre() const;
+    Heure getFinFenetre() const;
+    bool estChargeDeInstantane() const;
+    void evaluerMemoire(RapportMemoire &p_rapport) const;
+    static size_t validerModeAttente(const DonneesGTFS &p_gtfs, size_t p_nbRequetes, unsigned int p_graine,
+                                     std::ostream &p_rapport);
+
+    void construireSurcouche(const Coordonnees &p_pointOrigine, const Coordonnees &p_pointDestination,
+                             Surcouche &p_surcouche) const;
+    unsigned int itineraire(const DonneesGTFS &p_gtfs, const Coordonnees &p_pointOrigine,
+                            const Coordonnees &p_pointDestination, bool p_afficherItineraire,
+                            long &p_tempsExecution, ContexteItineraire &p_contexte) const;
+    void matriceDurees(const std::vector<Coordonnees> &p_origines, const std::vector<Coordonnees> &p_destinations,
+                       unsigned int p_nbFils, MatriceDurees &p_matrice) const;
+
+    static constexpr double vitesseDeMarche = IndexSpatial::vitesseDeMarche;     /*!< en km/h */
+    static constexpr double distanceMaxMarche = IndexSpatial::distanceMaxMarche; /*!< en km */
+    static constexpr unsigned int delaisMinArcsAttente = 60;  /*!< délai minimal d'un arc d'attente en secondes */
+    static constexpr unsigned int dureeMinSegment = 300;      /*!< segments de voyage mesurant la vitesse (secondes) */
+    static constexpr uint32_t versionInstantane = 4;          /*!< à incrémenter lorsque la construction du graphe change */
+    static constexpr size_t nbMinArretsParFil = 50000;        /*!< en deçà, la construction n'utilise pas d'autre fil */
+
+private:
+
+    bool estDansFenetre(const Arret &p_arret) const;
+    void numeroterArrets(const IdentifiantsGTFS &p_identifiants);
+    void associerStations(const IdentifiantsGTFS &p_identifiants);
+    void construireGraphe(const IdentifiantsGTFS &p_identifiants);
+    uint32_t premierDepart(uint32_t p_station, uint32_t p_heure) const;
+    void ajouterArcsVoyages(TamponArcs &p_tampon, size_t p_debut, size_t p_fin) const;
+    void ajouterArcsTransferts(const IdentifiantsGTFS &p_identifiants, TamponArcs &p_tampon,
+                               size_t p_debut, size_t p_fin) const;
+    void ajouterArcsAttente(const IdentifiantsGTFS &p_identifiants, TamponArcs &p_tampon,
+                            size_t p_debut, size_t p_fin) const;
+    void ajouterArcsAttenteLineaires(std::vector<std::pair<uint32_t, uint32_t> >::iterator p_debut,
+                                     std::vector<std::pair<uint32_t, uint32_t> >::iterator p_fin,
+                                     TamponArcs &p_tampon) const;
+    void calculerBorneVitesse();
+    void relierStations(const IdentifiantsGTFS &p_identifiants, const std::vector<uint8_t> &p_stationsRecalculees);
+    void appliquerRetards(const IdentifiantsGTFS &p_identifiants, const RetardsTempsReel &p_retards,
+                          uint32_t p_voyage, std::vector<uint32_t> &p_sommetsModifies);
+    void mettreAJourArcs(const IdentifiantsGTFS &p_identifiants, const Graphe &p_grapheSource,
+                         const std::vector<uint32_t> &p_sommetsModifies);
+    static uint64_t cleInstantane(const DonneesGTFS &p_gtfs, const std::string &p_repertoireGTFS,
+                                  ModeAttente p_modeAttente);
+    bool chargerInstantane(const DonneesGTFS &p_gtfs, const std::string &p_fichier, uint64_t p_cle);
+    void sauvegarderInstantane(const std::string &p_fichier, uint64_t p_cle) const;
+    void ajouterArcsOrigine(const Coordonnees &p_pointOrigine,
+                            std::vector<std::pair<size_t, unsigned int> > &p_arcs) const;
+    void ajouterArcsDestination(const Coordonnees &p_pointDestination,
+                                std::vector<std::pair<size_t, unsigned int> > &p_arcs) const;
+    void construireHeuristique(const Coordonnees &p_pointDestination, Heuristique &p_heuristique) const;
+    void afficherItineraire(const DonneesGTFS &p_gtfs, const std::vector<size_t> &p_chemin,
+                            unsigned int p_duree) const;
+
+    Graphe m_leGraphe;
+    IndexSpatial m_indexStations; /*!< stations de DonneesGTFS indexées par leurs coordonnées */
+    TableArrets m_arrets;
+    std::vector<uint32_t> m_numeroDuVoyage;        /*!< indice (IdentifiantsGTFS) du numéro de ligne de chaque voyage */
+    std::vector<Coordonnees> m_coordsStations;
+    std::vector<const Station *> m_stations;       /*!< pour l'affichage, dans l'ordre de DonneesGTFS::getStations() */
+    std::vector<const Voyage *> m_voyages;         /*!< pour l'affichage, dans l'ordre de DonneesGTFS::getVoyages() */
+    uint32_t m_debutFenetre;                       /*!< intervalle de temps [début, fin) en secondes depuis minuit */
+    uint32_t m_finFenetre;
+    double m_secondesParKm; /*!< temps par km le plus court des segments de voyage (0 si A* impossible) */
+    //liens arrivant à la station s: m_liensEntrants[m_debutLiensEntrants[s] .. m_debutLiensEntrants[s+1])
+    std::vector<uint32_t> m_debutLiensEntrants;
+    std::vector<LienStations> m_liensEntrants;
+    std::vector<LienStations> m_liensRapides; /*!< liens plus rapides que m_secondesParKm (voir construireHeuristique()) */
+    bool m_chargeDeInstantane;
+    std::shared_ptr<const void> m_instantane; /*!< projection de l'instantané où le graphe figé est lu, partagée par
+                                                   les copies du réseau */
+    ModeAttente m_modeAttente;
+};
+
+#endif //RESEAUPARTAGE_H
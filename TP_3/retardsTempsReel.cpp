@@ -0,0 +1,83 @@
+//
+//  RetardsTempsReel.cpp
+//  Retards des voyages lus d'un fichier local (substitut fichier de GTFS-Realtime)
+//
+
+#include "retardsTempsReel.h"
+#include <algorithm>
+#include <stdexcept>
+
+#include "lecteurCSV.h"
+
+using namespace std;
+
+//! \brief lit un fichier de retards: une ligne d'en-tête, puis trip_id,stop_sequence,delay (secondes, signe permis)
+//! \brief les retards d'un voyage présent dans le fichier remplacent tous ses retards précédents; un retard nul
+//! \brief remet le voyage à l'horaire. Les voyages absents de p_identifiants (p. ex. d'une autre date) sont ignorés.
+//! \param[out] p_voyagesModifies: les voyages présents dans le fichier, sans doublon, par indice croissant
+//! \return le nombre de lignes ignorées
+//! \throws logic_error si le fichier ne peut être lu ou si une ligne est invalide (les retards en vigueur sont
+//! \throws alors inchangés)
+size_t RetardsTempsReel::lire(const string &p_fichier, const IdentifiantsGTFS &p_identifiants,
+                              vector<uint32_t> &p_voyagesModifies)
+{
+    LecteurCSV lecteur(p_fichier);
+    vector<string_view> champs;
+    lecteur.lireLigne(champs); //en-tête
+
+    unordered_map<uint32_t, vector<pair<uint32_t, int32_t> > > lus;
+    size_t nbIgnorees = 0;
+    string voyageId;
+    while (lecteur.lireLigne(champs))
+    {
+        if (champs.size() < 3)
+            throw logic_error("RetardsTempsReel::lire(): ligne " + to_string(lecteur.getNumeroLigne()) +
+                              ": 3 champs attendus");
+        voyageId.assign(champs[0].data(), champs[0].size());
+        uint32_t voyage;
+        if (!p_identifiants.chercherVoyage(voyageId, voyage))
+        {
+            ++nbIgnorees;
+            continue;
+        }
+        const bool negatif = !champs[2].empty() && champs[2].front() == '-';
+        const int32_t delai = static_cast<int32_t>(LecteurCSV::lireEntier(negatif ? champs[2].substr(1) : champs[2]));
+        lus[voyage].emplace_back(LecteurCSV::lireEntier(champs[1]), negatif ? -delai : delai);
+    }
+
+    p_voyagesModifies.clear();
+    for (auto &voyage : lus)
+    {
+        stable_sort(voyage.second.begin(), voyage.second.end(),
+                    [](const pair<uint32_t, int32_t> &a, const pair<uint32_t, int32_t> &b) { return a.first < b.first; });
+        m_retards[voyage.first].swap(voyage.second);
+        p_voyagesModifies.push_back(voyage.first);
+    }
+    sort(p_voyagesModifies.begin(), p_voyagesModifies.end());
+    return nbIgnorees;
+}
+
+//! \return le retard en vigueur à l'arrêt de numéro de séquence p_sequence du voyage p_voyage (0 si aucun)
+int32_t RetardsTempsReel::retard(uint32_t p_voyage, uint32_t p_sequence) const
+{
+    auto voyage = m_retards.find(p_voyage);
+    if (voyage == m_retards.end()) return 0;
+    auto suivant = upper_bound(voyage->second.begin(), voyage->second.end(), p_sequence,
+                               [](uint32_t s, const pair<uint32_t, int32_t> &r) { return s < r.first; });
+    return suivant == voyage->second.begin() ? 0 : prev(suivant)->second;
+}
+
+//! \return les voyages ayant reçu des retards, par indice croissant
+vector<uint32_t> RetardsTempsReel::getVoyages() const
+{
+    vector<uint32_t> voyages;
+    voyages.reserve(m_retards.size());
+    for (const auto &voyage : m_retards) voyages.push_back(voyage.first);
+    sort(voyages.begin(), voyages.end());
+    return voyages;
+}
+
+size_t RetardsTempsReel::getNbVoyages() const
+{
+    return m_retards.size();
+}
@@ -0,0 +1,35 @@
+//
+//  RetardsTempsReel.h
+//  Retards des voyages lus d'un fichier local (substitut fichier de GTFS-Realtime)
+//
+
+#ifndef RETARDSTEMPSREEL_H
+#define RETARDSTEMPSREEL_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+#include "identifiantsGTFS.h"
+
+//! \brief Retards en vigueur de chaque voyage, en secondes (négatifs si le voyage est en avance)
+//! \brief Comme un StopTimeUpdate de GTFS-Realtime, le retard donné pour un numéro de séquence s'applique à cet arrêt
+//! \brief et aux suivants du voyage, jusqu'au prochain retard donné pour ce voyage.
+class RetardsTempsReel
+{
+public:
+
+    size_t lire(const std::string &p_fichier, const IdentifiantsGTFS &p_identifiants,
+                std::vector<uint32_t> &p_voyagesModifies);
+    int32_t retard(uint32_t p_voyage, uint32_t p_sequence) const;
+    std::vector<uint32_t> getVoyages() const;
+    size_t getNbVoyages() const;
+
+private:
+
+    //(numéro de séquence, retard) triés par numéro de séquence, par indice de voyage (IdentifiantsGTFS)
+    std::unordered_map<uint32_t, std::vector<std::pair<uint32_t, int32_t> > > m_retards;
+};
+
+#endif //RETARDSTEMPSREEL_H